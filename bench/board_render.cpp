@@ -0,0 +1,66 @@
+// Time to build a frame of a board with cards in every section, and to draw
+// it, the work ftxui does after every event. Cached is how the game runs,
+// the cards reuse the elements of their looks. Fresh drops those before
+// every frame, so every card builds it's element again like it did before
+// the cache.
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <ftxui/dom/elements.hpp>
+#include <ftxui/dom/node.hpp>
+#include <ftxui/screen/screen.hpp>
+#include <print>
+#include <solitairecpp/board.hpp>
+#include <solitairecpp/core.hpp>
+#include <solitairecpp/move_manager.hpp>
+#include <utility>
+
+using namespace solitairecpp;
+
+int main(int argc, char **argv) {
+  const std::uint64_t frames = argc > 1 ? std::atoll(argv[1]) : 10000;
+
+  // some moves in, so the waste and the foundations aren't empty
+  Session session(Difficulty::Easy, 1);
+  SplitMix64 random(1);
+  GameState::MoveList moves;
+  for (int i{}; i < 60; i++) {
+    const auto count = session.state().generateMoves(moves);
+    if (count == 0)
+      break;
+    auto move = moves[random.below(count)];
+    (void)session.apply(move);
+  }
+  Board board(std::move(session), {.onGameWon = [] {},
+                                   .restartGame = [] {},
+                                   .viewLeadearBoard = [] {}});
+  auto component = board.component();
+  auto screen = ft::Screen::Create(ft::Dimension::Fixed(160),
+                                   ft::Dimension::Fixed(60));
+
+  std::uint64_t checksum{};
+  const auto time = [&](bool fresh, bool draw) {
+    const auto start = std::chrono::steady_clock::now();
+    for (std::uint64_t frame{}; frame < frames; frame++) {
+      if (fresh)
+        board.clearCardElements();
+      auto element = component->Render();
+      if (draw)
+        ft::Render(screen, element);
+      checksum += element != nullptr;
+    }
+    const std::chrono::duration<double, std::micro> elapsed =
+        std::chrono::steady_clock::now() - start;
+    return elapsed.count() / frames;
+  };
+
+  for (bool draw : {false, true}) {
+    (void)time(false, draw); // every look the board shows gets built
+    const auto fresh = time(true, draw);
+    const auto cached = time(false, draw);
+    std::println("{}: fresh {:.1f} us, cached {:.1f} us per frame, {:.2f}x",
+                 draw ? "build and draw" : "build", fresh, cached,
+                 fresh / cached);
+  }
+  std::println("({})", checksum % 10);
+}
@@ -0,0 +1,68 @@
+// Measures the failing paths of the engine: illegal move probes and undo with
+// an empty history. These happen all the time while the player clicks around
+// and while tools search, so they should never touch the heap.
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <print>
+#include <solitairecpp/core.hpp>
+
+namespace {
+
+std::uint64_t allocations{};
+
+} // namespace
+
+void *operator new(std::size_t size) {
+  allocations++;
+  if (void *ptr = std::malloc(size == 0 ? 1 : size))
+    return ptr;
+  throw std::bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept { std::free(ptr); }
+void operator delete(void *ptr, std::size_t) noexcept { std::free(ptr); }
+
+namespace {
+
+using namespace solitairecpp;
+
+template <typename Function>
+void measure(const char *name, std::uint64_t iterations, Function function) {
+  const auto startAllocations = allocations;
+  const auto start = std::chrono::steady_clock::now();
+  std::uint64_t failures{};
+  for (std::uint64_t i{}; i < iterations; i++)
+    failures += function(i);
+  const std::chrono::duration<double, std::nano> elapsed =
+      std::chrono::steady_clock::now() - start;
+
+  std::println("{:<28} {:>10} failures {:>8.2f} ns/op {:>10} allocations",
+               name, failures, elapsed.count() / iterations,
+               allocations - startAllocations);
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  const std::uint64_t iterations = argc > 1 ? std::atoll(argv[1]) : 10000000;
+
+  GameState state(Difficulty::Hard, 1);
+  // every tableau to tableau move of 19 cards is illegal on a fresh deal
+  measure("illegal GameState::apply", iterations, [&](std::uint64_t i) {
+    Move move{.from = static_cast<PileId>(i % Piles::tableauSize),
+              .to = static_cast<PileId>((i + 1) % Piles::tableauSize),
+              .count = GameState::maxTableauRowSize};
+    return !state.apply(move).has_value();
+  });
+
+  Session session(Difficulty::Easy, 1);
+  measure("Session::undo when empty", iterations,
+          [&](std::uint64_t) { return !session.undo().has_value(); });
+
+  // what every failure used to cost, for comparison
+  measure("rich Error per failure", iterations, [&](std::uint64_t) {
+    return toError(ErrorCode::IllegalMove) != nullptr;
+  });
+}
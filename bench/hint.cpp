@@ -0,0 +1,62 @@
+// Time from a move to the next hint, with the per pile cache of HintEngine
+// and with every pile regenerated as if the cache was cold.
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <print>
+#include <solitairecpp/core.hpp>
+#include <solitairecpp/hint_engine.hpp>
+#include <vector>
+
+using namespace solitairecpp;
+
+int main(int argc, char **argv) {
+  const std::uint64_t rounds = argc > 1 ? std::atoll(argv[1]) : 100;
+  constexpr std::uint64_t deals = 64;
+  constexpr size_t playoutLength = 200;
+
+  // random playouts, replayed move by move so the cache sees real updates
+  std::vector<std::vector<Move>> playouts;
+  for (std::uint64_t deal{}; deal < deals; deal++) {
+    GameState state(deal % 2 ? Difficulty::Hard : Difficulty::Easy, deal);
+    SplitMix64 random(deal);
+    GameState::MoveList moves;
+    auto &playout = playouts.emplace_back();
+    for (size_t i{}; i < playoutLength; i++) {
+      const auto count = state.generateMoves(moves);
+      if (count == 0)
+        break;
+      auto move = moves[random.below(count)];
+      (void)state.apply(move);
+      playout.push_back(move);
+    }
+  }
+
+  const auto run = [&](bool cached) {
+    std::uint64_t hints{};
+    std::uint64_t positions{};
+    const auto start = std::chrono::steady_clock::now();
+    for (std::uint64_t round{}; round < rounds; round++) {
+      for (std::uint64_t deal{}; deal < deals; deal++) {
+        GameState state(deal % 2 ? Difficulty::Hard : Difficulty::Easy, deal);
+        HintEngine engine;
+        for (auto move : playouts[deal]) {
+          hints += engine.best(state).has_value();
+          (void)state.apply(move);
+          if (cached)
+            engine.touched(move);
+          else
+            engine.reset();
+          positions++;
+        }
+      }
+    }
+    const std::chrono::duration<double, std::nano> elapsed =
+        std::chrono::steady_clock::now() - start;
+    std::println("{:>8}: {:.0f} ns per move and hint, {} hints",
+                 cached ? "cached" : "cold", elapsed.count() / positions,
+                 hints);
+  };
+  run(false);
+  run(true);
+}
@@ -0,0 +1,48 @@
+// Positions per second of GameState::generateMoves over random playouts, the
+// rate every search tool built on top of it is capped by.
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <print>
+#include <solitairecpp/core.hpp>
+#include <vector>
+
+using namespace solitairecpp;
+
+int main(int argc, char **argv) {
+  const std::uint64_t rounds = argc > 1 ? std::atoll(argv[1]) : 1000;
+  constexpr std::uint64_t deals = 64;
+  constexpr size_t playoutLength = 200;
+
+  // collect the positions first so only the generator gets timed. Few enough
+  // to stay in cache, a search mostly revisits nearby positions too.
+  std::vector<GameState> positions;
+  positions.reserve(deals * playoutLength);
+  for (std::uint64_t deal{}; deal < deals; deal++) {
+    GameState state(deal % 2 ? Difficulty::Hard : Difficulty::Easy, deal);
+    SplitMix64 random(deal);
+    GameState::MoveList moves;
+    for (size_t i{}; i < playoutLength; i++) {
+      positions.emplace_back(state);
+      const auto count = state.generateMoves(moves);
+      if (count == 0)
+        break;
+      auto move = moves[random.below(count)];
+      (void)state.apply(move);
+    }
+  }
+
+  GameState::MoveList moves;
+  std::uint64_t generated{};
+  const auto start = std::chrono::steady_clock::now();
+  for (std::uint64_t round{}; round < rounds; round++)
+    for (const auto &position : positions)
+      generated += position.generateMoves(moves);
+  const std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+
+  const double total = static_cast<double>(positions.size()) * rounds;
+  std::println("{} positions, {:.2f} moves each, {:.2f} M positions/s",
+               positions.size(), generated / total,
+               total / elapsed.count() / 1e6);
+}
@@ -0,0 +1,113 @@
+// Size of a saved game and the time to load it, against dealing the game
+// again and replaying it's moves, for games with short and long histories.
+// Then what saving costs the game thread, with Autosave and in place.
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <print>
+#include <solitairecpp/autosave.hpp>
+#include <solitairecpp/core.hpp>
+#include <solitairecpp/snapshot.hpp>
+#include <vector>
+
+using namespace solitairecpp;
+
+int main(int argc, char **argv) {
+  const std::uint64_t rounds = argc > 1 ? std::atoll(argv[1]) : 1000;
+  const auto path =
+      (std::filesystem::temp_directory_path() / "bench-snapshot.bin").string();
+
+  for (size_t length : {0, 100, 1000, 4000}) {
+    Session session(Difficulty::Hard, length);
+    SplitMix64 random(length);
+    GameState::MoveList moves;
+    std::vector<Move> played;
+    while (played.size() < length) {
+      const auto count = session.state().generateMoves(moves);
+      if (count == 0)
+        break;
+      auto move = moves[random.below(count)];
+      if (session.apply(move))
+        played.push_back(move);
+    }
+
+    auto written = Snapshot::write(path, session, {});
+    if (!written) {
+      std::println("{}", written.error()->what());
+      return 1;
+    }
+
+    std::uint64_t checksum{};
+    auto start = std::chrono::steady_clock::now();
+    for (std::uint64_t round{}; round < rounds; round++) {
+      auto loaded = Snapshot::load(path);
+      if (!loaded || loaded->session.state() != session.state()) {
+        std::println("the snapshot doesn't load back");
+        return 1;
+      }
+      checksum += loaded->session.state().hash();
+    }
+    const std::chrono::duration<double, std::micro> load =
+        std::chrono::steady_clock::now() - start;
+
+    start = std::chrono::steady_clock::now();
+    for (std::uint64_t round{}; round < rounds; round++) {
+      Session replayed(Difficulty::Hard, length);
+      for (auto move : played)
+        (void)replayed.apply(move);
+      checksum += replayed.state().hash();
+    }
+    const std::chrono::duration<double, std::micro> replay =
+        std::chrono::steady_clock::now() - start;
+
+    std::println("{:>5} moves: {:>6} bytes, load {:.1f} us, deal and replay "
+                 "{:.1f} us ({:x})",
+                 played.size(), std::filesystem::file_size(path),
+                 load.count() / rounds, replay.count() / rounds,
+                 checksum & 0xFFFF);
+  }
+
+  // a move per save, like the game does
+  Session session(Difficulty::Easy, 1);
+  GameState::MoveList moves;
+  SplitMix64 random(1);
+  const auto play = [&] {
+    const auto count = session.state().generateMoves(moves);
+    if (count == 0)
+      return;
+    auto move = moves[random.below(count)];
+    (void)session.apply(move);
+  };
+  const std::uint64_t saves = std::min<std::uint64_t>(rounds, 1000);
+
+  auto start = std::chrono::steady_clock::now();
+  for (std::uint64_t i{}; i < saves; i++) {
+    play();
+    (void)Snapshot::write(path, session, {});
+  }
+  const std::chrono::duration<double, std::micro> inPlace =
+      std::chrono::steady_clock::now() - start;
+
+  // only the save() calls, that's what the game thread waits for
+  Autosave autosave(path);
+  std::vector<double> calls;
+  for (std::uint64_t i{}; i < saves; i++) {
+    play();
+    const auto before = std::chrono::steady_clock::now();
+    autosave.save(session, {});
+    calls.push_back(std::chrono::duration<double, std::micro>(
+                        std::chrono::steady_clock::now() - before)
+                        .count());
+  }
+  autosave.flush();
+  std::ranges::sort(calls);
+
+  std::println("in place: {:.1f} us per save", inPlace.count() / saves);
+  std::println("autosave: {:.1f} us median per save, {:.1f} us p99, {} of {} "
+               "saves written",
+               calls[calls.size() / 2], calls[calls.size() * 99 / 100],
+               autosave.writes(), autosave.saves());
+  std::filesystem::remove(path);
+}
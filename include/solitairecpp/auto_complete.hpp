@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <solitairecpp/engine.hpp>
+#include <solitairecpp/session.hpp>
+#include <vector>
+
+namespace solitairecpp {
+
+// Finishes games without asking. Safe foundation moves are always taken, they
+// never have to be taken back. Once the game is decided every foundation move
+// is taken too, drawing through the waste when none is left on the tableau.
+// Only needs the core, the bots use it the same way the board does.
+class AutoComplete {
+public:
+  // Every tableau card is face up. The rows are runs then, so the lowest card
+  // left is either on top of one or comes up by drawing, and the game always
+  // plays out. The stock doesn't have to be empty, drawing refills it anyway.
+  static bool decided(const GameState &state);
+  // Empty when auto-complete has nothing to do
+  static std::optional<Move> next(const GameState &state);
+  // Applies moves until next has none, returns them in order. They're in
+  // the session's history like any other move.
+  static std::vector<Move> run(Session &session);
+
+private:
+  // Hard mode reshuffles the waste and only shows every third card, so the
+  // one that's needed can take a few rounds to come up. Gives up after this
+  // many draws in a row, which never happens in practice.
+  static constexpr size_t maxIdleDraws_ = 16 * GameState::deckSize;
+};
+
+} // namespace solitairecpp
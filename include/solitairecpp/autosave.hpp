@@ -0,0 +1,60 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <solitairecpp/session.hpp>
+#include <solitairecpp/snapshot.hpp>
+#include <stop_token>
+#include <string>
+#include <thread>
+
+namespace solitairecpp {
+
+// Keeps the snapshot of the game on disk current without the game thread
+// ever waiting for the disk.
+//
+// save() encodes the snapshot into the front buffer, a few microseconds, and
+// wakes the writer thread. The writer swaps the buffers and stores the back
+// one (write, fsync, rename) with the lock released. Saves that come in while
+// it's busy overwrite the front buffer, so a burst of moves ends up as one
+// write of the latest state. Snapshot::store never touches the old file
+// before the new one is complete, a crash mid write keeps the previous save.
+class Autosave {
+public:
+  explicit Autosave(std::string path);
+  // Stores the last save if the writer hasn't got to it yet
+  ~Autosave();
+  Autosave(const Autosave &) = delete;
+  Autosave &operator=(const Autosave &) = delete;
+
+  void save(const Session &session, const Snapshot::Progress &progress);
+  // Drops a pending save and deletes the snapshot, for games that are over
+  void discard();
+  // Blocks until everything handed over so far is on disk
+  void flush();
+
+  std::uint64_t saves() const;  // handed to save()
+  std::uint64_t writes() const; // that hit the disk, the rest got coalesced
+
+private:
+  enum class Pending { None, Store, Remove };
+
+  void run(std::stop_token stop);
+
+private:
+  std::string path_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable_any wake_;
+  std::condition_variable idle_;
+  std::string front_; // filled by save()
+  std::string back_;  // only the writer touches it
+  Pending pending_{Pending::None};
+  bool busy_{};
+  std::uint64_t saves_{};
+  std::uint64_t writes_{};
+  std::jthread writer_; // last, it uses everything above
+};
+
+} // namespace solitairecpp
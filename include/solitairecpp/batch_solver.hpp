@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstdint>
+#include <expected>
+#include <format>
+#include <functional>
+#include <solitairecpp/engine.hpp>
+#include <solitairecpp/error.hpp>
+#include <solitairecpp/solver.hpp>
+#include <string>
+#include <vector>
+
+namespace solitairecpp {
+
+class ErrorResultsFile : public ErrorBase {
+public:
+  ErrorResultsFile(const std::string &path, const std::string &reason)
+      : path_{path}, reason_{reason} {}
+
+  std::string what() override {
+    return std::format("Can't use results file {}: {}", path_, reason_);
+  }
+
+  Error error() override {
+    return std::make_shared<ErrorResultsFile>(path_, reason_);
+  }
+
+private:
+  std::string path_;
+  std::string reason_;
+};
+
+// Solves a range of deal numbers on a pool of threads, each with it's own
+// Solver, and appends one csv line per deal to a results file:
+//
+//   deal,status,moves,nodes,microseconds
+//
+// Deals already in the file are skipped, so an interrupted run picks up where
+// it stopped when started again with the same file. Lines get written in
+// batches, a crash loses at most the last batch of every thread.
+class BatchSolver {
+public:
+  struct Options {
+    std::uint64_t from{}; // both inclusive
+    std::uint64_t to{};
+    Difficulty mode{};
+    size_t threads{1};
+    Solver::Limits limits{};
+    std::string path;
+  };
+
+  struct Summary {
+    std::uint64_t solved{};
+    std::uint64_t unsolvable{};
+    std::uint64_t unknown{};
+    std::uint64_t skipped{}; // found in the file already
+  };
+
+  // One line of a results file, what building the deal database needs
+  struct Record {
+    std::uint64_t deal{};
+    Solver::Status status{};
+    std::uint64_t nodes{};
+  };
+
+  struct Results {
+    Difficulty mode{};
+    std::vector<Record> records;
+  };
+
+  // Called on the calling thread about once a second
+  typedef std::function<void(std::uint64_t done, std::uint64_t total)>
+      Progress;
+
+public:
+  explicit BatchSolver(const Options &options);
+
+  std::expected<Summary, Error> run(const Progress &progress = {});
+
+  // Reads a results file back, a half written last line is left out
+  static std::expected<Results, Error> read(const std::string &path);
+
+private:
+  static constexpr size_t batchSize_ = 256;
+  Options options_;
+};
+
+} // namespace solitairecpp
@@ -2,21 +2,20 @@
 
 #include <ftxui/component/component_base.hpp>
 #include <functional>
+#include <memory>
 #include <solitairecpp/cards.hpp>
+#include <solitairecpp/engine.hpp>
+#include <solitairecpp/hint_engine.hpp>
+#include <solitairecpp/journal.hpp>
+#include <solitairecpp/session.hpp>
+#include <solitairecpp/win_estimator.hpp>
 #include <utility>
+#include <variant>
 
 namespace solitairecpp {
 
 class MoveManager;
 
-enum class Difficulty { Easy, Hard };
-
-enum class BoardSection {
-  Tableau,
-  ReserveStack,
-  Foundations,
-};
-
 // useful for debug and errors
 static const char *BoardSectionStr(BoardSection section) {
   switch (section) {
@@ -48,91 +47,53 @@ private:
   BoardSection section_;
 };
 
+// The sections below are only views, the cards themselves live in the engine's
+// Session owned by the board.
 class Tableau {
 public:
-  static constexpr size_t startCardsSize = 28;
-  typedef std::array<Card, startCardsSize> StartCards;
-
   struct CardPosition {
     size_t cardRowIndex{};
     size_t cardIndex{};
     bool operator==(const CardPosition &other) const;
   };
 
-  // We always append at the end so a card position is unnecessary
-  struct AppendCardPosition {
-    size_t cardRowIndex{};
-
-    bool operator==(const AppendCardPosition &other) const;
-  };
-
 public:
-  Tableau(StartCards cards,
-          MoveManager &moveManager); // Copying on purpose
+  Tableau(MoveManager &moveManager);
   ft::Component component() const;
-  std::expected<CardPosition, Error> search(const CardCode &code) const;
-  std::expected<void, Error> appendTo(const AppendCardPosition &pos,
-                                      const Cards &cards);
-  std::expected<void, Error> appendToRollback(const AppendCardPosition &pos,
-                                              const Cards &cards);
-  std::expected<void, Error> deleteFrom(const CardPosition &pos);
-  std::expected<Cards, Error> getCardsFrom(const CardPosition &pos);
-
-  std::expected<bool, Error> isAppendToLegal(const AppendCardPosition &pos,
-                                             const Cards &cards);
+  void sync(size_t row, const GameState &state, const CardCache &cache);
 
 private:
   MoveManager &moveManager_;
-  std::array<CardRow, 7> tableau_ =
+  std::array<CardRow, Piles::tableauSize> tableau_ =
       [&]<std::size_t... Is>(std::index_sequence<Is...>) {
-        return std::array<CardRow, 7>{
+        return std::array<CardRow, Piles::tableauSize>{
             {std::vector<CardRow>(sizeof...(Is), CardRow(Is, moveManager_))
                  .at(Is)...}};
-      }(std::make_index_sequence<7>{});
+      }(std::make_index_sequence<Piles::tableauSize>{});
 };
 
 class ReserveStack {
 public:
-  static constexpr size_t startCardsSize = 24;
-  typedef std::array<Card, startCardsSize> StartCards;
-
   struct CardPosition {}; // it's empty because we always will take the top one
                           // no matter the difficulty
 
 public:
-  ReserveStack(Difficulty mode, MoveManager &moveManager,
-               StartCards cards); // Copying on purpose
+  ReserveStack(const GameState &state, MoveManager &moveManager);
   void reveal();
   ft::Component component();
-  std::expected<CardPosition, Error> searchViewable(const CardCode &code);
-  std::expected<Card, Error> getTopCard();
-  std::expected<void, Error> deleteTopCard();
-  std::expected<void, Error> setTopCard(const Card &card);
-  std::expected<void, Error> rollbackCard();
-
-private:
-  class ReserveStackCard : public Card {
-  public:
-    ReserveStackCard(const Card &card, const ReserveStack &reserveStack);
-    ft::Component component() const override;
-
-  private:
-    const ReserveStack &reserveStack_;
-  };
+  void sync(const GameState &state, const CardCache &cache);
 
 private:
-  void moveToHiddenAndShuffle();
-  ft::Component placeholder();
-  void revealEasy();
-  void revealHard();
+  ft::Element renderButton(const ft::EntryState &state);
 
 private:
-  static constexpr size_t hardDifficultyViewableAmount = 3;
-  Difficulty mode_;
-  Cards hiddenCards_;
-  Cards viewedCards_;
+  const GameState &state_;
   ft::Component viewableCardsComponent_;
   MoveManager &moveManager_;
+  // built the first time they're drawn, like the cards. The button has 3
+  // labels, each with or without hint, active and focused.
+  std::array<ft::Element, 3 * 8> buttonElements_;
+  ft::Element emptyWaste_;
 };
 
 class Foundations {
@@ -142,33 +103,21 @@ public:
   };
 
 public:
-  Foundations(MoveManager &moveManager, std::function<void()> onGameWon);
-  std::expected<Card, Error> acquireCard(const CardPosition &pos);
-  std::expected<void, Error> deleteCard(const CardPosition &pos);
-  std::expected<void, Error> setCard(const CardPosition &pos, const Card &card);
+  Foundations(MoveManager &moveManager);
   ft::Component component();
-
-  // search is not directly needed but it eases
-  // the job for classes that use it
-  std::expected<CardPosition, Error> search(const CardCode &code);
-  std::expected<bool, Error> isSetLegal(const CardPosition &pos,
-                                        const Card &card);
-
-private:
-  class FoundationCard : public Card {
-  public:
-    FoundationCard(const Card &card);
-    ft::Component component() const override;
-  };
+  void sync(size_t index, const GameState &state, const CardCache &cache);
 
 private:
   ft::Component placeholder(size_t index);
+  ft::Element renderPlaceholder(size_t index, const ft::EntryState &state);
 
 private:
-  std::array<Cards, 4> foundations_;
+  std::array<ft::Component, Piles::foundationsSize> placeholders_;
+  // per placeholder, a look is hint, move open, active and focused
+  std::array<std::array<ft::Element, 16>, Piles::foundationsSize>
+      placeholderElements_;
   ft::Component component_;
   MoveManager &moveManager_;
-  std::function<void()> onGameWon_;
 };
 
 class ExitButton {
@@ -187,29 +136,57 @@ public:
     std::function<void()> onGameWon;
     std::function<void()> restartGame;
     std::function<void()> viewLeadearBoard;
+    // after every change of the game state and once for the start position
+    std::function<void(const Session &)> onChanged;
   };
 
 public:
-  Board(Difficulty mode, GameCallbacks callbacks);
+  // analysis adds the win chance to the side panel. Every change of the game
+  // state goes into journal when there is one.
+  Board(Session session, GameCallbacks callbacks, bool analysis = false,
+        JournalWriter *journal = nullptr);
   // non-copyable
   Board(const Board &) = delete;
   Board &operator=(const Board &) = delete;
 
   std::expected<CardPosition, Error> search(const CardCode &code) const;
   ft::Component component() const;
-  Cards buildDeck();
 
-  ReserveStack &reserveStack() const;
-  Tableau &tableau() const;
-  Foundations &foundations() const;
+  // The only way the game state changes, syncs the views of touched piles
+  std::expected<void, ErrorCode> apply(Move &move);
+  std::expected<void, ErrorCode> undo();
+  std::expected<void, ErrorCode> redo();
+  // Applies every move AutoComplete picks and syncs each touched pile once,
+  // returns how many moves that was
+  size_t autoComplete();
 
+  const GameState &state() const;
+  const Session &session() const;
   size_t moveCount() const;
+  // The move to suggest, kept up to date by the syncs
+  std::optional<Move> hint();
+  // The cards build their elements again on the next frame, for measuring
+  // what keeping them saves
+  void clearCardElements();
+
+private:
+  void syncPile(PileId pile);
+  void syncMove(const Move &move);
+  void positionChanged();
+  void record(const Journal::Record &record);
 
 private:
+  static constexpr size_t analysisRollouts_ = 4'096;
+
+  Session session_;
+  std::unique_ptr<MoveManager> moveManager_;
+  std::unique_ptr<CardCache> cardCache_;
   std::unique_ptr<Tableau> tableau_ = nullptr;
   std::unique_ptr<ReserveStack> reserveStack_ = nullptr;
   std::unique_ptr<Foundations> foundations_ = nullptr;
-  std::unique_ptr<MoveManager> moveManager_;
+  HintEngine hints_;
+  std::unique_ptr<WinEstimator> estimator_; // only in analysis
+  JournalWriter *journal_;
   GameCallbacks gameCallbacks_;
 };
 
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <format>
+#include <solitairecpp/error.hpp>
+#include <string>
+
+namespace solitairecpp {
+
+enum class CardValue {
+  Ace,
+  Two,
+  Three,
+  Four,
+  Five,
+  Six,
+  Seven,
+  Eight,
+  Nine,
+  Ten,
+  Jack,
+  Queen,
+  King,
+  Count // Need to itarate over this enum
+};
+
+enum class CardType { Hearts, Diamonds, Spades, Clubs, Count };
+
+enum class CardColor { Red, Black };
+
+// Due to each card in the deck being unique we can idenitfy them by thier value
+// combined with thier type/color.
+struct CardCode {
+  CardValue value;
+  CardType type;
+  bool operator==(const CardCode &rhs) const;
+};
+
+class ErrorInvalidCardRange : public ErrorBase {
+public:
+  std::string what() override {
+    return "The card range supplied has the wrong color";
+  }
+
+  Error error() override { return std::make_shared<ErrorInvalidCardRange>(); }
+};
+
+class ErrorInvalidCardIndex : public ErrorBase {
+public:
+  std::string what() override {
+    return "Tried to access a card at a non-existsent index";
+  }
+
+  Error error() override { return std::make_shared<ErrorInvalidCardIndex>(); }
+};
+
+class ErrorCardPositionNotFound : public ErrorBase {
+public:
+  ErrorCardPositionNotFound(const CardCode &code) : code_{code} {}
+
+  std::string what() override {
+    return std::format("Card with the supplied code was not found: {} {}",
+                       static_cast<size_t>(code_.value),
+                       static_cast<size_t>(code_.type));
+  }
+
+  Error error() override {
+    return std::make_shared<ErrorCardPositionNotFound>(code_);
+  }
+
+private:
+  CardCode code_;
+};
+
+} // namespace solitairecpp
@@ -1,12 +1,16 @@
 #pragma once
 
+#include <array>
 #include <expected>
 #include <ftxui/component/component.hpp>
 #include <ftxui/component/component_base.hpp>
 #include <ftxui/dom/elements.hpp>
+#include <memory>
+#include <solitairecpp/card_code.hpp>
+#include <solitairecpp/engine.hpp>
 #include <solitairecpp/error.hpp>
 #include <string>
-#include <vector>
+#include <unordered_map>
 
 namespace ft = ftxui;
 
@@ -14,104 +18,76 @@ namespace solitairecpp {
 
 class MoveManager;
 
-enum class CardValue {
-  Ace,
-  Two,
-  Three,
-  Four,
-  Five,
-  Six,
-  Seven,
-  Eight,
-  Nine,
-  Ten,
-  Jack,
-  Queen,
-  King,
-  Count // Need to itarate over this enum
-};
-
-enum class CardType { Hearts, Diamonds, Spades, Clubs, Count };
-
-enum class CardColor { Red, Black };
-
-// Due to each card in the deck being unique we can idenitfy them by thier value
-// combined with thier type/color.
-struct CardCode {
-  CardValue value;
-  CardType type;
-  bool operator==(const CardCode &rhs) const;
-};
-
-class ErrorInvalidCardRange : public ErrorBase {
-public:
-  std::string what() override {
-    return "The card range supplied has the wrong color";
-  }
-
-  Error error() override { return std::make_shared<ErrorInvalidCardRange>(); }
-};
-
-class ErrorInvalidCardIndex : public ErrorBase {
-public:
-  std::string what() override {
-    return "Tried to access a card at a non-existsent index";
-  }
-
-  Error error() override { return std::make_shared<ErrorInvalidCardIndex>(); }
-};
-
-class ErrorCardPositionNotFound : public ErrorBase {
-public:
-  ErrorCardPositionNotFound(const CardCode &code) : code_{code} {}
-
-  std::string what() override {
-    return std::format("Card with the supplied code was not found: {} {}",
-                       static_cast<size_t>(code_.value),
-                       static_cast<size_t>(code_.type));
-  }
-
-  Error error() override {
-    return std::make_shared<ErrorCardPositionNotFound>(code_);
-  }
-
-private:
-  CardCode code_;
+enum class BoardSection {
+  Tableau,
+  ReserveStack,
+  Foundations,
 };
 
+// The ui side of a card. Every card gets exactly one of these for the whole
+// game, the piles of the engine only decide where it's component is attached.
 class Card {
 public:
-  Card(MoveManager &moveManager, CardValue value, CardType type,
-       std::string art, bool hidden = true);
-  Card &operator=(const Card &other);
+  Card(MoveManager &moveManager, CardCode code, std::string art);
+  // non-copyable, the component refers back to it
+  Card(const Card &) = delete;
+  Card &operator=(const Card &) = delete;
 
-  void show();
-  void showWithoutStatusChange(); // Used for init
-  void hideRollback();
+  // Called by the board whenever the card lands in a new spot
+  void place(BoardSection section, bool hidden, bool selectable = true);
   CardCode code() const;
-  virtual ft::Component component() const;
   CardColor color() const;
+  bool hidden() const;
+  ft::Component component() const;
+  // Drops the elements kept for each look, the next frame builds them again
+  void clearElements();
 
   static inline const auto cardWidth = ft::size(ft::WIDTH, ft::EQUAL, 15);
   static inline const auto cardHeight = ft::size(ft::HEIGHT, ft::EQUAL, 1);
 
-protected:
-  bool hiddenStatusChanged = false;
+private:
+  // What a drawn card looks like besides it's code, bits of the index into
+  // elements_
+  static constexpr size_t lookHidden = 1;
+  static constexpr size_t lookHint = 2;
+  static constexpr size_t lookActive = 4;
+  static constexpr size_t lookFocused = 8;
+  static constexpr size_t looks = 16;
+
+  void onClick();
+  // Picks the look, the element of it is only built the first time
+  ft::Element render(const ft::EntryState &state) const;
+  ft::Element build(size_t look) const;
+
+private:
   ft::Component component_;
-  CardColor color_;
+  // ftxui lays an element out again every frame, so the same one can be
+  // drawn frame after frame. A card is on the board once, it never shows up
+  // twice in a frame.
+  mutable std::array<ft::Element, looks> elements_;
   MoveManager &moveManager_;
+  CardCode code_;
+  CardColor color_;
   std::string art_ = "art not initalized";
   static constexpr inline std::string backsideArt_ = "Solitairecpp"; // art btw
 
-private:
-  std::shared_ptr<bool> hidden_;
-  CardValue value_;
-  CardType type_;
+  BoardSection section_ = BoardSection::Tableau;
+  bool hidden_ = true;
+  bool selectable_ = true; // only the top card of the reserve stack is
 };
 
-typedef std::vector<Card> Cards;
+// Owns the component of every card, indexed by the packed card code
+class CardCache {
+public:
+  CardCache(MoveManager &moveManager);
+  Card &at(PackedCard card) const;
+  void clearElements();
+
+private:
+  std::array<std::unique_ptr<Card>, GameState::deckSize> cards_;
+};
 
-// wrapper around std::vector
+// View of a single tableau row
 class CardRow {
 public:
   struct CardPosition {
@@ -121,20 +97,12 @@ public:
 public:
   CardRow(size_t index, MoveManager &moveManager);
   ft::Component component() const;
-  std::expected<void, Error> append(const Cards &cards);
-  void appendRollback(const Cards &cards);
-  void appendCore(const Cards &cards); // Used by normal append, appendRollback
-                                       // and init this interface will get
-                                       // encapsulated by tableau
-  std::expected<void, Error> deleteFrom(const CardPosition &pos);
-  std::expected<Cards, Error> getCardsFrom(const CardPosition &pos);
-  std::expected<CardPosition, Error> search(const CardCode &code) const;
-
-  bool isAppendLegal(const Cards &cards);
+  // Reattaches the cached components in the order of the engine row
+  void sync(const GameState::TableauRow &row, const CardCache &cache);
 
 private:
   ft::Component cardsComponent_;
-  Cards cards_;
+  size_t size_{};
   size_t index_;
   MoveManager &moveManager_;
 };
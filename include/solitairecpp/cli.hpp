@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstdint>
+#include <expected>
+#include <format>
+#include <optional>
+#include <solitairecpp/engine.hpp>
+#include <solitairecpp/error.hpp>
+#include <solitairecpp/simulator.hpp>
+#include <string>
+
+namespace solitairecpp {
+
+class ErrorInvalidArgument : public ErrorBase {
+public:
+  ErrorInvalidArgument(const std::string &argument) : argument_{argument} {}
+
+  std::string what() override {
+    return std::format("Invalid argument: {}", argument_);
+  }
+
+  Error error() override {
+    return std::make_shared<ErrorInvalidArgument>(argument_);
+  }
+
+private:
+  std::string argument_;
+};
+
+class Cli {
+public:
+  struct DealRange {
+    std::uint64_t from{};
+    std::uint64_t to{};
+  };
+
+  struct Options {
+    std::optional<std::uint64_t> dealNumber; // only for the first game
+    bool analysis{};
+    bool help{};
+
+    // headless modes, the game doesn't start when one is given
+    std::optional<DealRange> solveRange;
+    std::optional<std::string> buildDealDatabase; // the results to read
+    std::optional<std::uint64_t> simulate;        // how many games
+    std::optional<std::string> replay;            // the journal
+
+    // settings of the headless modes
+    Difficulty mode{};
+    Simulator::Agent agent{Simulator::Agent::Greedy};
+    std::optional<size_t> threads; // all cores when not given
+    std::optional<std::uint64_t> maxNodes;
+    std::optional<std::string> output; // every mode has it's own default
+    std::optional<std::uint64_t> speed; // replays on the board when given
+  };
+
+  static std::expected<Options, Error> parse(int argc, char **argv);
+  static std::string usage();
+
+private:
+  // These consume the value following the flag at argv[i]
+  static std::expected<std::string, Error> value(int &i, int argc,
+                                                 char **argv);
+  static std::expected<std::uint64_t, Error> numberValue(int &i, int argc,
+                                                         char **argv);
+  static std::expected<Difficulty, Error> modeValue(int &i, int argc,
+                                                    char **argv);
+  static std::expected<Simulator::Agent, Error> agentValue(int &i, int argc,
+                                                           char **argv);
+  static std::expected<std::uint64_t, Error>
+  parseNumber(const std::string &arg);
+};
+
+} // namespace solitairecpp
@@ -0,0 +1,9 @@
+#pragma once
+
+// Everything the solitairecpp_core library offers. Doesn't depend on ftxui, so
+// it's safe to include from headless tools.
+#include <solitairecpp/card_code.hpp>
+#include <solitairecpp/engine.hpp>
+#include <solitairecpp/error.hpp>
+#include <solitairecpp/move_log.hpp>
+#include <solitairecpp/session.hpp>
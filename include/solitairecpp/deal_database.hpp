@@ -0,0 +1,74 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <solitairecpp/engine.hpp>
+#include <solitairecpp/error.hpp>
+#include <solitairecpp/mapped_file.hpp>
+#include <string>
+#include <vector>
+
+namespace solitairecpp {
+
+// Winnable deal numbers of one mode, read straight from a memory map.
+//
+// The deals are split into buckets by how hard the solver had to work on
+// them. Every bucket is sorted and stored as varint deltas, with a checkpoint
+// (absolute deal number and byte offset) every checkpointStride deals. Finding
+// the n-th deal decodes at most checkpointStride - 1 deltas, so drawing one
+// is constant time and only touches a page or two.
+//
+// Layout, little endian:
+//   "SCDB", u8 version, u8 mode, u16 checkpoint stride
+//   per bucket: u64 count, u64 offset, u64 size
+//   per bucket at offset: count / stride rounded up checkpoints of
+//   u64 deal and u64 delta offset, then the deltas
+class DealDatabase {
+public:
+  enum class Rating : std::uint8_t { Quick, Medium, Long, Count };
+  static constexpr size_t ratingCount = static_cast<size_t>(Rating::Count);
+  static constexpr size_t checkpointStride = 64;
+
+  typedef std::array<std::vector<std::uint64_t>, ratingCount> Buckets;
+
+  // From the nodes the solver needed
+  static Rating rate(std::uint64_t nodes);
+
+  // Writes to a temporary file first and renames it over path
+  static std::expected<void, Error> write(const std::string &path,
+                                          Difficulty mode, Buckets buckets);
+  static std::expected<DealDatabase, Error> open(const std::string &path);
+
+  Difficulty mode() const;
+  size_t size() const;
+  size_t size(Rating rating) const;
+  std::uint64_t at(Rating rating, size_t index) const;
+  // Uniform over all the deals or over one rating, random can be any random
+  // number. 0 when there's nothing to draw from, so check size first.
+  std::uint64_t draw(std::uint64_t random) const;
+  std::uint64_t draw(Rating rating, std::uint64_t random) const;
+
+private:
+  struct Bucket {
+    std::uint64_t count{};
+    const std::byte *checkpoints{};
+    const std::byte *deltas{};
+    const std::byte *end{};
+  };
+
+  DealDatabase(MappedFile file, Difficulty mode,
+               std::array<Bucket, ratingCount> buckets);
+
+private:
+  static constexpr std::uint8_t version_ = 1;
+  static constexpr size_t headerSize_ = 8 + ratingCount * 24;
+  static constexpr size_t checkpointSize_ = 16;
+
+  MappedFile file_;
+  Difficulty mode_;
+  std::array<Bucket, ratingCount> buckets_;
+};
+
+} // namespace solitairecpp
@@ -0,0 +1,285 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <optional>
+#include <solitairecpp/card_code.hpp>
+#include <solitairecpp/error.hpp>
+#include <solitairecpp/random.hpp>
+#include <span>
+#include <type_traits>
+
+namespace solitairecpp {
+
+enum class Difficulty { Easy, Hard };
+
+class ErrorIllegalMove : public ErrorBase {
+public:
+  std::string what() override { return "Tried to perform an illegal move"; }
+
+  Error error() override { return std::make_shared<ErrorIllegalMove>(); }
+};
+
+// A card packed into a single byte. The low 6 bits hold value * 4 + type, the
+// high bit marks a card that's face down. This is what the engine works with,
+// the ui only maps these to it's components.
+class PackedCard {
+public:
+  constexpr PackedCard() = default;
+  constexpr PackedCard(CardCode code, bool faceDown = false)
+      : bits_{static_cast<std::uint8_t>(
+            static_cast<std::uint8_t>(code.value) * typeCount +
+            static_cast<std::uint8_t>(code.type) +
+            (faceDown ? faceDownBit : 0))} {}
+
+  static constexpr PackedCard fromIndex(size_t index) {
+    PackedCard card;
+    card.bits_ = static_cast<std::uint8_t>(index);
+    return card;
+  }
+
+  // 0-51, unique for every card in the deck
+  constexpr size_t index() const { return bits_ & indexMask; }
+  constexpr CardValue value() const {
+    return static_cast<CardValue>(index() / typeCount);
+  }
+  constexpr CardType type() const {
+    return static_cast<CardType>(index() % typeCount);
+  }
+  constexpr CardCode code() const { return {.value = value(), .type = type()}; }
+  // Hearts and Diamonds come first in CardType
+  constexpr CardColor color() const {
+    return index() % typeCount < 2 ? CardColor::Red : CardColor::Black;
+  }
+  constexpr bool faceDown() const { return bits_ & faceDownBit; }
+  constexpr PackedCard withFaceDown(bool faceDown) const {
+    PackedCard card;
+    card.bits_ =
+        static_cast<std::uint8_t>(index() + (faceDown ? faceDownBit : 0));
+    return card;
+  }
+  constexpr std::uint8_t bits() const { return bits_; }
+
+  constexpr bool operator==(const PackedCard &other) const = default;
+
+private:
+  static constexpr std::uint8_t typeCount =
+      static_cast<std::uint8_t>(CardType::Count);
+  static constexpr std::uint8_t faceDownBit = 0x80;
+  static constexpr std::uint8_t indexMask = 0x3F;
+
+  std::uint8_t bits_{};
+};
+
+static_assert(sizeof(PackedCard) == 1);
+
+// Fixed capacity stack of cards. Never allocates, so the whole game state stays
+// trivially copyable.
+template <size_t Capacity> class Pile {
+public:
+  constexpr size_t size() const { return size_; }
+  constexpr bool empty() const { return size_ == 0; }
+  static constexpr size_t capacity() { return Capacity; }
+
+  // unchecked, the engine validates indexes before touching piles
+  constexpr PackedCard at(size_t index) const { return cards_[index]; }
+  constexpr PackedCard &at(size_t index) { return cards_[index]; }
+  constexpr PackedCard back() const { return cards_[size_ - 1]; }
+  constexpr PackedCard &back() { return cards_[size_ - 1]; }
+
+  constexpr void push(PackedCard card) { cards_[size_++] = card; }
+  constexpr PackedCard pop() { return cards_[--size_]; }
+  constexpr void resize(size_t size) {
+    size_ = static_cast<std::uint8_t>(size);
+  }
+
+  constexpr const PackedCard *begin() const { return cards_.data(); }
+  constexpr const PackedCard *end() const { return cards_.data() + size_; }
+  constexpr PackedCard *begin() { return cards_.data(); }
+  constexpr PackedCard *end() { return cards_.data() + size_; }
+
+  // slots past size() may hold stale cards, so only the live ones are compared
+  constexpr bool operator==(const Pile &other) const {
+    return size_ == other.size_ && std::equal(begin(), end(), other.begin());
+  }
+
+private:
+  std::array<PackedCard, Capacity> cards_{};
+  std::uint8_t size_{};
+};
+
+// Every pile of the board gets a one byte id, so that moves can be packed
+typedef std::uint8_t PileId;
+
+struct Piles {
+  static constexpr size_t tableauSize = 7;
+  static constexpr size_t foundationsSize = 4;
+
+  static constexpr PileId stock = 7;
+  static constexpr PileId waste = 8;
+  static constexpr PileId firstFoundation = 9;
+  static constexpr PileId count = 13;
+
+  static constexpr PileId tableau(size_t row) {
+    return static_cast<PileId>(row);
+  }
+  static constexpr PileId foundation(size_t index) {
+    return static_cast<PileId>(firstFoundation + index);
+  }
+  static constexpr bool isTableau(PileId pile) { return pile < stock; }
+  static constexpr bool isFoundation(PileId pile) {
+    return pile >= firstFoundation && pile < count;
+  }
+  static constexpr size_t foundationIndex(PileId pile) {
+    return pile - firstFoundation;
+  }
+};
+
+// A move packed into 4 bytes. from and to are pile ids, count is the amount of
+// cards that changed piles. Flags get filled in by GameState::apply and carry
+// what's needed to undo the move.
+struct Move {
+  static constexpr std::uint8_t revealedFlag = 1 << 0; // card below got flipped
+  static constexpr std::uint8_t recycledFlag = 1 << 1; // waste went to stock
+
+  PileId from{};
+  PileId to{};
+  std::uint8_t count{};
+  std::uint8_t flags{};
+
+  // Revealing cards from the reserve stack is a move from stock to waste
+  static constexpr Move draw() {
+    return {.from = Piles::stock, .to = Piles::waste};
+  }
+  constexpr bool isDraw() const { return from == Piles::stock; }
+
+  constexpr bool operator==(const Move &other) const = default;
+};
+
+static_assert(sizeof(Move) == 4);
+
+class GameState {
+public:
+  static constexpr size_t deckSize = 52;
+  static constexpr size_t tableauStartCards = 28;
+  static constexpr size_t reserveStackStartCards = 24;
+  static constexpr size_t hardDifficultyViewableAmount = 3;
+  // 6 face down cards and a full King to Ace sequence
+  static constexpr size_t maxTableauRowSize = 19;
+  static constexpr size_t foundationSize =
+      static_cast<size_t>(CardValue::Count);
+
+  typedef std::array<CardCode, deckSize> Deck;
+  typedef Pile<maxTableauRowSize> TableauRow;
+  typedef Pile<reserveStackStartCards> ReserveCards;
+  typedef Pile<foundationSize> Foundation;
+
+  // No position has more moves than this, generateMoves never overflows it.
+  // Runs go to at most 2 rows each (the two cards one higher of the other
+  // color), plus foundation, waste and draw moves.
+  static constexpr size_t maxMoves = 256;
+  typedef std::array<Move, maxMoves> MoveList;
+
+  struct Location {
+    PileId pile{};
+    std::uint8_t depth{}; // index from the bottom of the pile
+
+    bool operator==(const Location &other) const = default;
+  };
+
+public:
+  GameState() = default;
+  // The first 28 cards of the deck go to the tableau, the rest to the stock
+  GameState(Difficulty mode, std::uint64_t dealNumber);
+
+  // Fisher-Yates over the ordered deck, driven by SplitMix64 seeded with the
+  // deal number. Don't change this, deal numbers have to stay stable.
+  static Deck buildDeck(std::uint64_t dealNumber);
+
+  // Puts the cards straight into their piles, for loading a saved game.
+  // cards holds every pile bottom to top, in pile id order. Empty unless
+  // every card of the deck is there once and the piles fit.
+  static std::optional<GameState>
+  restore(Difficulty mode, std::uint64_t dealNumber, size_t recycles,
+          const std::array<std::uint8_t, Piles::count> &sizes,
+          std::span<const PackedCard, deckSize> cards);
+
+  // The same position as far as the player can tell: the face down tableau
+  // cards are dealt again at random, and so is the stock. Until the first
+  // recycle the stock is mixed in with the face down cards, after it only
+  // it's order gets shuffled. Reshuffles get seeded by seed too, which also
+  // becomes the deal number of the sample.
+  GameState sample(std::uint64_t seed) const;
+
+  Difficulty mode() const;
+  std::uint64_t dealNumber() const;
+  size_t recycles() const; // how many times the waste got reshuffled
+  const TableauRow &tableauRow(size_t row) const;
+  const ReserveCards &stock() const;
+  const ReserveCards &waste() const;
+  const Foundation &foundation(size_t index) const;
+  size_t pileSize(PileId pile) const;
+  PackedCard pileCard(PileId pile, size_t depth) const;
+
+  // Amount of cards of the waste shown to the player, only the top is movable
+  size_t viewableWasteSize() const;
+
+  // Constant time, backed by an index that apply and undo keep up to date
+  Location locate(const CardCode &code) const;
+  Location locate(PackedCard card) const;
+
+  bool isAppendLegal(size_t row, const PackedCard *cards, size_t count) const;
+  bool isSetLegal(size_t foundation, PackedCard card) const;
+  bool isLegal(const Move &move) const;
+  // Writes every legal move into moves and returns how many there are. Empty
+  // rows and empty foundations are interchangeable, so moves that only differ
+  // in which of them they target are generated once, for the first one.
+  // Foundation moves come first.
+  size_t generateMoves(MoveList &moves) const;
+  // A move to the foundations that never has to be taken back: every card
+  // that could go on top of the moved one in the tableau is on the
+  // foundations already. Solvers and auto-play take these without branching.
+  bool isSafeFoundationMove(const Move &move) const;
+
+  // Fills in the flags of the move on success
+  std::expected<void, ErrorCode> apply(Move &move);
+  // Only valid for the last move applied
+  void undo(const Move &move);
+
+  bool won() const;
+
+  // Zobrist hash of the cards, their face down bits and the reshuffle count.
+  // apply and undo keep it up to date, so reading it is free.
+  std::uint64_t hash() const;
+
+  bool operator==(const GameState &other) const = default;
+
+private:
+  // Refreshes the index and the hash for every card of the pile from depth
+  // upwards
+  void relocate(PileId pile, size_t depth = 0);
+  // Rebuilds the whole index and hash, after cards got placed directly
+  void reindex();
+  void flip(PackedCard &card); // turns the card over, keeping the hash right
+  SplitMix64 recycleGenerator() const;
+  void recycle();
+  void unrecycle();
+
+private:
+  std::array<TableauRow, Piles::tableauSize> tableau_{};
+  std::array<Foundation, Piles::foundationsSize> foundations_{};
+  ReserveCards stock_{};
+  ReserveCards waste_{};
+  std::array<Location, deckSize> locations_{}; // indexed by PackedCard::index
+  std::uint64_t hash_{}; // without the reshuffle count, hash() adds it
+  Difficulty mode_{};
+  std::uint16_t recycles_{};
+  std::uint64_t dealNumber_{};
+};
+
+static_assert(std::is_trivially_copyable_v<GameState>);
+
+} // namespace solitairecpp
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <type_traits>
@@ -27,4 +28,17 @@ public:
 
 typedef ErrorBase::Error Error;
 
+// What the engine returns instead of an Error. It's a single byte, so the
+// routine failures (illegal move probes, nothing to undo) don't allocate.
+// The ui turns it into the matching ErrorBase with toError once it has to
+// show or throw it.
+enum class ErrorCode : std::uint8_t {
+  IllegalMove,
+  InvalidCardIndex,
+  NothingToUndo,
+  NothingToRedo,
+};
+
+Error toError(ErrorCode code);
+
 } // namespace solitairecpp
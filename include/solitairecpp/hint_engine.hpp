@@ -0,0 +1,49 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <solitairecpp/engine.hpp>
+
+namespace solitairecpp {
+
+// Picks the move to suggest to the player. The legal moves out of every pile
+// are cached and only the piles a move touched get looked at again: their
+// own moves are regenerated and every other pile rechecks just the moves into
+// them. Ranking goes through Solver::rank each time, it depends on more than
+// the two piles of a move and costs next to nothing for a dozen moves.
+class HintEngine {
+public:
+  HintEngine() = default;
+
+  // Call after every move applied or undone
+  void touched(const Move &move);
+  // For a position that wasn't reached by moves
+  void reset();
+  // Empty when nothing but useless moves are left
+  std::optional<Move> best(const GameState &state);
+
+private:
+  // A run holds one card of every value, so there's at most one move from a
+  // pile to each of the 11 targets
+  static constexpr size_t maxSourceMoves_ = 16;
+  static constexpr size_t sourceCount_ = Piles::waste + 1;
+  static constexpr std::uint16_t allPiles_ = (1 << Piles::count) - 1;
+
+  struct Source {
+    std::array<Move, maxSourceMoves_> moves;
+    std::uint8_t count{};
+  };
+
+  void refresh(const GameState &state);
+  // Appends the legal moves from one pile to another
+  static void add(const GameState &state, PileId from, PileId to,
+                  Source &source);
+  static bool isDirty(std::uint16_t dirty, PileId pile);
+
+private:
+  std::array<Source, sourceCount_> sources_{};
+  std::uint16_t dirty_ = allPiles_; // piles touched since the last refresh
+};
+
+} // namespace solitairecpp
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <fstream>
+#include <optional>
+#include <solitairecpp/engine.hpp>
+#include <solitairecpp/error.hpp>
+#include <solitairecpp/mapped_file.hpp>
+#include <solitairecpp/session.hpp>
+#include <string>
+
+namespace solitairecpp {
+
+// Everything that happened to a game, enough to play it again move by move.
+// Recycle shuffles are seeded from the deal number, so the deal and the moves
+// give back the exact same positions.
+//
+// Layout, little endian:
+//   "SCRJ", u8 version, u8 mode, u16 reserved, u64 deal number
+//   then one u16 per record: kind in bits 0-1, and for applied moves from in
+//   bits 2-5, to in bits 6-9 and count in bits 10-15
+//
+// Flags and the count of draws aren't stored, apply fills them in again.
+class Journal {
+public:
+  enum class Kind : std::uint8_t { Apply, Undo, Redo };
+
+  struct Record {
+    Kind kind{};
+    Move move{}; // only for Apply
+
+    bool operator==(const Record &other) const = default;
+  };
+
+  static constexpr size_t headerSize = 16;
+  static constexpr size_t recordSize = 2;
+
+  static std::uint16_t pack(const Record &record);
+  static std::optional<Record> unpack(std::uint16_t bits);
+
+  // A half written last record from a crash is left out
+  static std::expected<Journal, Error> open(const std::string &path);
+
+  Difficulty mode() const;
+  std::uint64_t dealNumber() const;
+  size_t size() const;
+  // Empty when the record is garbage
+  std::optional<Record> at(size_t index) const;
+
+  // Does to the session what the record says
+  static std::expected<void, ErrorCode> replay(Session &session,
+                                               const Record &record);
+
+private:
+  Journal(MappedFile file, Difficulty mode, std::uint64_t dealNumber);
+
+private:
+  MappedFile file_;
+  Difficulty mode_{};
+  std::uint64_t dealNumber_{};
+};
+
+// Appends the records of one game as they happen. Every record is flushed
+// right away, a crash loses nothing but the record being written, and at a
+// player's pace that's a few bytes a second.
+class JournalWriter {
+public:
+  // Truncates path, creating the directory if needed
+  static std::expected<JournalWriter, Error>
+  create(const std::string &path, Difficulty mode, std::uint64_t dealNumber);
+  // Goes on with the journal of a resumed game, which has to be of the same
+  // deal. It's cut back to the records the snapshot counted, whatever came
+  // after them was never saved, and fails when it has fewer.
+  static std::expected<JournalWriter, Error>
+  append(const std::string &path, Difficulty mode, std::uint64_t dealNumber,
+         size_t records);
+  // Starts the journal of a resumed game over from it's undo log, when the
+  // old journal is lost. Fails when the log doesn't go back to the deal.
+  static std::expected<JournalWriter, Error> rebuild(const std::string &path,
+                                                     const Session &session);
+
+  void record(const Journal::Record &record);
+  // Records on disk, one that failed to write isn't counted
+  size_t size() const;
+
+private:
+  JournalWriter(std::ofstream out, size_t records);
+
+private:
+  std::ofstream out_;
+  size_t records_{};
+};
+
+} // namespace solitairecpp
@@ -1,20 +1,40 @@
 #pragma once
 
+#include <chrono>
+#include <cstdint>
 #include <ftxui/component/component.hpp>
-#include <vector>
+#include <solitairecpp/engine.hpp>
+#include <solitairecpp/par_pool.hpp>
+#include <solitairecpp/paths.hpp>
+#include <solitairecpp/score_table.hpp>
+#include <optional>
+#include <string>
 
 namespace ft = ftxui;
 
 namespace solitairecpp {
 
+// The won games, kept on disk by a ScoreTable so they survive restarts.
+//
+// The table shows one page of a view at a time: every game ranked, the
+// games of this week in either mode ranked, or every game newest first.
+// Only the rows of the page shown get built, so opening it costs the same
+// with a hundred games or a million.
 class Leaderboard {
 public:
-  struct LeaderboardEntry {
-    size_t gameNumber{};
-    size_t moveCount{};
-  };
+  // Rows on a page
+  static constexpr size_t shownEntries = 20;
 
-  void registerScore(size_t moveCount);
+  // Par gets looked up when the score comes in, the pool has usually had the
+  // whole game to work it out. Scores are read from path when first shown.
+  explicit Leaderboard(const ParPool &par,
+                       std::string path = Paths::leaderboard().string());
+
+  void registerScore(size_t moveCount, Difficulty mode,
+                     std::uint64_t dealNumber,
+                     std::chrono::milliseconds duration);
+  // The fewest moves anyone won the deal in
+  std::optional<size_t> best(Difficulty mode, std::uint64_t dealNumber);
 
   ft::Component component();
 
@@ -27,7 +47,8 @@ private:
 /_____/\___/\__,_/\__,_/\___/_/  /_.___/\____/\__,_/_/   \__,_/
 
 )";
-  std::vector<LeaderboardEntry> leaderboard_;
+  const ParPool *par_;
+  ScoreTable scores_;
 };
 
 } // namespace solitairecpp
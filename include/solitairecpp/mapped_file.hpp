@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <expected>
+#include <format>
+#include <solitairecpp/error.hpp>
+#include <span>
+#include <string>
+
+namespace solitairecpp {
+
+class ErrorFile : public ErrorBase {
+public:
+  ErrorFile(const std::string &path, const std::string &reason)
+      : path_{path}, reason_{reason} {}
+
+  std::string what() override {
+    return std::format("{}: {}", path_, reason_);
+  }
+
+  Error error() override { return std::make_shared<ErrorFile>(path_, reason_); }
+
+private:
+  std::string path_;
+  std::string reason_;
+};
+
+// Read only memory map of a whole file. The pages get loaded as they're
+// touched, so opening is instant no matter the size.
+class MappedFile {
+public:
+  static std::expected<MappedFile, Error> open(const std::string &path);
+
+  MappedFile(MappedFile &&other) noexcept;
+  MappedFile &operator=(MappedFile &&other) noexcept;
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+  ~MappedFile();
+
+  std::span<const std::byte> bytes() const;
+
+private:
+  MappedFile(const std::byte *data, size_t size);
+  void unmap();
+
+private:
+  const std::byte *data_{};
+  size_t size_{};
+};
+
+} // namespace solitairecpp
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <solitairecpp/engine.hpp>
+#include <vector>
+
+namespace solitairecpp {
+
+// Undo and redo history as a ring of packed moves. The buffer is allocated
+// once, after that pushing, undoing and redoing are constant time. When the
+// ring is full the oldest move is dropped. Moves carry their own flags
+// (revealed card, recycle), so nothing else is needed to invert them.
+class MoveLog {
+public:
+  static constexpr size_t defaultCapacity = 4096;
+
+  explicit MoveLog(size_t capacity = defaultCapacity);
+
+  // Drops whatever could have been redone
+  void push(const Move &move);
+  // Moves the cursor back and returns the move to invert
+  std::optional<Move> undo();
+  // Moves the cursor forward and returns the move to apply again
+  std::optional<Move> redo();
+
+  size_t undoSize() const;
+  size_t redoSize() const;
+  size_t capacity() const;
+  // Oldest first, the undoable moves and then the redoable ones
+  const Move &at(size_t index) const;
+
+private:
+  size_t slot(size_t offset) const;
+
+private:
+  std::vector<Move> buffer_;
+  size_t begin_{}; // oldest undoable move
+  size_t undoSize_{};
+  size_t redoSize_{};
+};
+
+} // namespace solitairecpp
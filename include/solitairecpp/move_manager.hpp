@@ -1,79 +1,95 @@
+#pragma once
+
 #include <atomic>
+#include <cstdint>
 #include <ftxui/component/component.hpp>
+#include <optional>
 #include <solitairecpp/board.hpp>
 #include <solitairecpp/cards.hpp>
+#include <solitairecpp/engine.hpp>
 #include <solitairecpp/error.hpp>
 
 namespace solitairecpp {
 
-class ErrorIllegalMove : public ErrorBase {
-public:
-  std::string what() override { return "Tried to perform an illegal move"; }
-
-  Error error() override { return std::make_shared<ErrorIllegalMove>(); }
-};
-
 class MoveManager {
 public:
-  MoveManager(const Board &elements);
+  MoveManager(Board &elements);
 
   void cardSelected(const CardCode &code);
   void setMoveOrigin(const CardPosition &code);
   void setMoveTarget(const CardCode &code);
   void setMoveTarget(const CardPosition &pos);
+  // Reveals from the reserve stack, a move being picked gets dropped first
+  void draw();
 
   bool isMoveTarget(const CardPosition &pos) const;
   bool isTargetError(const CardPosition &pos) const;
+  // The cards the hint moves and the spot they go to
+  bool isHint(const CardPosition &pos) const;
+  bool isHint(const CardCode &code) const;
+  bool isDrawHint() const; // the hint is revealing from the reserve stack
   bool moveTransactionOpen() const;
   size_t moveCount() const;
 
   ft::Component rollbackButton();
+  ft::Component redoButton();
+  ft::Component hintButton();
+  ft::Component autoCompleteButton();
 
   ft::ComponentDecorator moveTransactionCanceledListener();
 
 private:
-  struct moveTransaction {
-    CardPosition from;
-    CardPosition to;
-  };
+  // Move() below hides the engine type
+  typedef solitairecpp::Move EngineMove;
 
 private:
-  std::expected<void, Error> Move();
-  // Each overload describes a posssible origin and destination
-  std::expected<void, Error> moveHelper(const Tableau::CardPosition &from,
-                                        const Tableau::CardPosition &to);
-  std::expected<void, Error> moveHelper(const Tableau::CardPosition &from,
-                                        const Foundations::CardPosition &to);
-  std::expected<void, Error> moveHelper(const ReserveStack::CardPosition &from,
-                                        const Tableau::CardPosition &to);
-  std::expected<void, Error> moveHelper(const ReserveStack::CardPosition &from,
-                                        const Foundations::CardPosition &to);
+  std::expected<void, ErrorCode> Move();
+  // Translates what the user clicked into a move the engine understands
+  std::expected<EngineMove, ErrorCode>
+  toEngineMove(const CardPosition &from, const CardPosition &to) const;
 
   void rollback();
-
-  // Yes the equivalents for rollbacks are needed and aren't just repetition
-  void rollbackHelper(const Tableau::CardPosition &from,
-                      const Tableau::CardPosition &to);
-  void rollbackHelper(const Foundations::CardPosition &from,
-                      const Tableau::CardPosition &to);
-  void rollbackHelper(const Tableau::CardPosition &from,
-                      const ReserveStack::CardPosition &to);
-  void rollbackHelper(const Foundations::CardPosition &from,
-                      const ReserveStack::CardPosition &to);
-  void rollbackHelper(const ReserveStack::CardPosition &from,
-                      const ReserveStack::CardPosition &to);
+  void redo();
+  void hint();
+  void autoComplete();
+  std::optional<EngineMove> currentHint() const;
 
   void endTransaction();
+  // The cards isHint(code) is true for, one bit per card index
+  std::uint64_t hintCards(const EngineMove &move) const;
+
+private:
+  // The whole transaction lives in one word so the render transforms only
+  // do a plain load. Every position takes a 16 bit slot: a present bit, the
+  // board section, the row and the card index. The hint slot holds an engine
+  // move instead: a present bit, from and to piles and the card count.
+  typedef std::uint64_t TransactionWord;
+  typedef std::uint16_t PackedPosition;
+
+  static constexpr unsigned moveFromShift_ = 0;
+  static constexpr unsigned moveToShift_ = 16;
+  static constexpr unsigned erroneusTargetShift_ = 32;
+  static constexpr unsigned hintShift_ = 48;
+  static constexpr PackedPosition positionPresent_ = 0x8000;
+
+  static PackedPosition pack(const CardPosition &pos);
+  static std::optional<CardPosition> unpack(PackedPosition packed);
+  static PackedPosition packHint(const EngineMove &move);
+  static std::optional<EngineMove> unpackHint(PackedPosition packed);
+  static PackedPosition slot(TransactionWord word, unsigned shift);
+  static TransactionWord withSlot(TransactionWord word, unsigned shift,
+                                  PackedPosition packed);
+
+  void store(unsigned shift, PackedPosition packed);
 
 private:
-  static constexpr size_t maxHistorySize_ = 3;
-  std::vector<moveTransaction> history_;
-  const Board &board_;
-  std::atomic<std::optional<CardPosition>>
-      moveFrom_; // only when move sequence is initiated
-  std::atomic<std::optional<CardPosition>> moveTo_;
-  std::atomic<std::optional<CardPosition>> erroneusTarget_;
-  std::atomic<size_t> moveCount_{};
+  Board &board_;
+  // the from slot is only set when a move sequence is initiated
+  std::atomic<TransactionWord> transaction_{};
+  // worked out when a hint is given, so a card drawing itself only tests a
+  // bit. Only read while the hint slot is set, every hint sets it first.
+  std::atomic<std::uint64_t> hintCards_{};
+  static_assert(std::atomic<TransactionWord>::is_always_lock_free);
 };
 
 } // namespace solitairecpp
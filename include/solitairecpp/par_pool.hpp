@@ -0,0 +1,84 @@
+#pragma once
+
+#include <array>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <optional>
+#include <solitairecpp/engine.hpp>
+#include <solitairecpp/par_solver.hpp>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace solitairecpp {
+
+// Works out the par of deals on background threads and keeps every result,
+// so asking again for a deal seen before is only a lookup.
+//
+// Solved and unsolvable pars also go to a file, read back when the pool is
+// made, so a deal is only solved once. Unknown ones get tried again next
+// time, the limits may have hit because the machine was busy.
+//
+// Layout, little endian:
+//   "SCPR", u8 version, 3 reserved bytes
+//   16 bytes a deal: u64 deal number, u8 mode, u8 status (Solver::Status),
+//   u16 moves, u32 weight in thousandths
+class ParPool {
+public:
+  struct Par {
+    Solver::Status status{};
+    size_t moves{}; // when solved
+    double weight{}; // see ParSolver::Result
+  };
+
+public:
+  static constexpr size_t headerSize = 8;
+  static constexpr size_t recordSize = 16;
+
+public:
+  // Nothing is kept on disk without a path
+  explicit ParPool(size_t threads = 1,
+                   const ParSolver::Limits &limits = ParSolver::Limits{},
+                   std::string path = {});
+  // Stops the searches that are still running
+  ~ParPool();
+
+  // Queues the deal unless it's queued or known already
+  void request(Difficulty mode, std::uint64_t dealNumber);
+  // Empty while the deal is still queued or being solved
+  std::optional<Par> find(Difficulty mode, std::uint64_t dealNumber) const;
+
+private:
+  struct Job {
+    Difficulty mode;
+    std::uint64_t dealNumber;
+  };
+
+  void run(std::stop_token stop);
+  void load();
+  // A failed write only costs the par next time
+  void store(const Job &job, const Par &par);
+
+  // one map per mode, indexed by Difficulty
+  typedef std::array<std::unordered_map<std::uint64_t, std::optional<Par>>, 2>
+      Cache;
+
+  ParSolver::Limits limits_;
+  std::string path_;
+  std::mutex fileMutex_; // for the rest of the file members
+  std::uint64_t records_{}; // whole records in the file
+  bool readOnly_{}; // not a par file, left alone
+  std::ofstream out_; // opened with the first store
+  mutable std::mutex mutex_;
+  std::condition_variable_any wake_;
+  std::deque<Job> queue_;
+  Cache cache_; // empty optionals are queued or running
+  std::vector<std::jthread> threads_;
+};
+
+} // namespace solitairecpp
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <solitairecpp/engine.hpp>
+#include <solitairecpp/solver.hpp>
+#include <solitairecpp/transposition_table.hpp>
+#include <stop_token>
+#include <vector>
+
+namespace solitairecpp {
+
+// Iterative deepening A* for the shortest winning move list, the par of a
+// deal. Every iteration is a depth first search that drops positions whose
+// moves so far plus weight times lowerBound go over a threshold, the next
+// iteration raises it to the smallest value that got dropped.
+//
+// With a weight of 1 the first solution found is the shortest one among the
+// moves Solver::candidates keeps, but on most deals that takes far more nodes
+// than anyone wants to spend. A weight w finds one at most w times as long
+// quickly, so the search starts at startWeight and halves the distance to
+// weight every pass, only looking for solutions shorter than the best so far.
+// When the limits hit, the best one is the result.
+//
+// Before the first pass Solver looks for any solution. It takes a fraction of
+// the nodes, caps the passes from the start and is the par when none of them
+// finishes in time.
+//
+// The transposition table holds the fewest moves each position was reached
+// with in the current iteration, a longer way there is cut off.
+class ParSolver {
+public:
+  struct Limits {
+    size_t memoryBytes = 32 << 20; // for the transposition table
+    std::uint64_t maxNodes = 20'000'000;
+    std::chrono::milliseconds maxTime{10'000};
+    size_t maxRecycles = 3;
+    double startWeight = 3.0;
+    double weight = 1.0; // of the last pass
+    // of the first solution, it's nodes and time count against the above
+    Solver::Limits first;
+  };
+
+  struct Result {
+    Solver::Status status{Solver::Status::Unknown};
+    std::vector<Move> moves; // only when solved, par is their count
+    // of the last finished pass, no solution is shorter than moves / weight.
+    // 1 only when no unpromising move got cut, the shortest for sure. 0 when
+    // the moves are Solver's and no pass found shorter ones, no bound then.
+    double weight{};
+    std::uint64_t nodes{};
+    size_t iterations{};
+    std::chrono::duration<double> elapsed{};
+  };
+
+public:
+  ParSolver();
+  explicit ParSolver(const Limits &limits);
+
+  // A stop request makes it return Unknown soon after
+  Result solve(const GameState &state, std::stop_token stop = {});
+
+  // Never more than the moves left to win:
+  // - every card not on the foundations needs a move there, one at a time
+  // - the stock only empties by draws, of one or three cards
+  // - a tableau row with a card above a lower one of its suit needs a move
+  //   to take it off, foundation moves can't since the lower one goes first
+  static size_t lowerBound(const GameState &state);
+
+private:
+  enum class Pass { Found, Exhausted, OutOfLimits };
+
+  // One weighted IDA* run for a solution shorter than cap, which goes into
+  // result.moves
+  Pass search(const GameState &start, double weight, size_t cap,
+              Result &result, std::stop_token stop,
+              std::chrono::steady_clock::time_point begin);
+
+  struct Frame {
+    size_t offset; // of the candidates in moves_
+    size_t count;
+    size_t next{};
+  };
+
+  Limits limits_;
+  Solver first_;
+  TranspositionTable table_;
+  bool cut_{}; // of this solve, see Solver::candidates
+  std::vector<Move> moves_;
+  std::vector<Frame> frames_;
+};
+
+} // namespace solitairecpp
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <solitairecpp/engine.hpp>
+#include <solitairecpp/solver.hpp>
+#include <solitairecpp/transposition_table.hpp>
+#include <vector>
+
+namespace solitairecpp {
+
+// The Solver search spread over threads that share one transposition table.
+// Each thread runs its own depth first search. One that runs out of work
+// steals an unexplored move from the bottom of another thread's stack, where
+// the subtrees are the largest, and replays the moves leading to it.
+class ParallelSolver {
+public:
+  struct Result : Solver::Result {
+    std::vector<std::uint64_t> threadNodes; // to see how evenly work spread
+    std::uint64_t steals{};
+  };
+
+public:
+  ParallelSolver(const Solver::Limits &limits, size_t threads);
+
+  Result solve(const GameState &state);
+
+private:
+  struct Frame {
+    size_t offset; // of the candidates in Worker::moves
+    size_t count;
+    size_t next{};
+  };
+
+  // Everything but the state is guarded by mutex, thieves read path and
+  // frames. The owner only locks to change them, which is never contended
+  // for long.
+  struct Worker {
+    std::mutex mutex;
+    GameState state;
+    std::vector<Move> path; // from the root, frame i is at path size base + i
+    size_t base{};
+    std::vector<Move> moves;
+    std::vector<Frame> frames;
+    std::uint64_t nodes{};
+  };
+
+  void run(size_t index);
+  // Pops the next move of the top frame, backtracking over finished ones.
+  // False once the worker's whole subtree is searched.
+  bool next(Worker &worker, Move &move);
+  // Takes a move off the lowest frame with any left, across all workers
+  bool steal(Worker &thief, size_t index);
+  // Sets up the worker on the position after path, unless it's seen already
+  void start(Worker &worker, std::vector<Move> path);
+  void expand(Worker &worker);
+  void finish(Solver::Status status, const std::vector<Move> *path = nullptr);
+
+private:
+  Solver::Limits limits_;
+  TranspositionTable table_;
+  std::vector<std::unique_ptr<Worker>> workers_;
+
+  GameState root_;
+  std::chrono::steady_clock::time_point begin_;
+  std::atomic<bool> stop_{};
+  std::atomic<size_t> active_{}; // workers with something on their stack
+  std::atomic<std::uint64_t> nodes_{};
+  std::atomic<std::uint64_t> steals_{};
+  std::atomic<bool> cut_{}; // see Solver::candidates
+  std::mutex resultMutex_;
+  Result result_;
+};
+
+} // namespace solitairecpp
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <filesystem>
+#include <solitairecpp/engine.hpp>
+
+namespace solitairecpp {
+
+class Paths {
+public:
+  // $XDG_DATA_HOME/solitairecpp or ~/.local/share/solitairecpp, the working
+  // directory when neither is set. Not created here.
+  static std::filesystem::path dataDirectory();
+  static std::filesystem::path dealDatabase(Difficulty mode);
+  // Of the game being played, or the last one. Replaced when a game starts.
+  static std::filesystem::path journal();
+  // The game being played, saved after every move. Resumed on the next start
+  // and only removed once the game is won.
+  static std::filesystem::path snapshot();
+  static std::filesystem::path leaderboard();
+  // Pars worked out so far, so a deal is solved once
+  static std::filesystem::path pars();
+};
+
+} // namespace solitairecpp
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <solitairecpp/engine.hpp>
+#include <vector>
+
+namespace solitairecpp {
+
+// Counts the positions reachable in exactly depth moves, walking every move
+// generateMoves returns. The numbers for a deal only change when the rules or
+// the generator do, which makes it a regression check as well as a benchmark.
+class Perft {
+public:
+  struct RootMove {
+    Move move;
+    std::uint64_t leaves{};
+  };
+
+  static std::uint64_t count(GameState &state, size_t depth);
+  // Splits at the root, threads take root moves until none are left. Returns
+  // the leaves under every root move in generation order.
+  static std::vector<RootMove> divide(const GameState &state, size_t depth,
+                                      size_t threads);
+};
+
+} // namespace solitairecpp
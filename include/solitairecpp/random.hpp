@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstdint>
+
+namespace solitairecpp {
+
+// SplitMix64 (Steele, Lea and Flood 2014). 8 bytes of state, a handful of
+// instructions per number and fully specified, so a deal number produces the
+// same deal on every platform. std::shuffle and std::uniform_int_distribution
+// are implementation defined, which is why they aren't used for dealing.
+class SplitMix64 {
+public:
+  constexpr explicit SplitMix64(std::uint64_t seed) : state_{seed} {}
+
+  constexpr std::uint64_t next() {
+    state_ += 0x9E3779B97F4A7C15ULL;
+    return mix(state_);
+  }
+
+  // Uniform in [0, bound). Values below 2^64 % bound get rejected so that
+  // there's no modulo bias.
+  constexpr std::uint64_t below(std::uint64_t bound) {
+    const std::uint64_t threshold = -bound % bound;
+    std::uint64_t value = next();
+    while (value < threshold)
+      value = next();
+    return value % bound;
+  }
+
+  // The SplitMix64 output function, good for turning a seed into another one
+  static constexpr std::uint64_t mix(std::uint64_t value) {
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+    return value ^ (value >> 31);
+  }
+
+private:
+  std::uint64_t state_;
+};
+
+} // namespace solitairecpp
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <fstream>
+#include <map>
+#include <optional>
+#include <set>
+#include <solitairecpp/engine.hpp>
+#include <solitairecpp/error.hpp>
+#include <solitairecpp/solver.hpp>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace solitairecpp {
+
+// Every won game of the leaderboard, in an append-only file and indexes in
+// memory.
+//
+// Nothing is read until the scores are first needed. Then the file is memory
+// mapped and indexed in one pass, after that adding a game is an append and
+// a few O(log n) inserts. Games are ranked by moves over par, games without a
+// par go after those in order of move count, ties go to the earlier game.
+//
+// The indexes answer the leaderboard's questions without a scan: all games
+// ranked, the games of one mode and week ranked, the best game of a deal and
+// every game in the order they were played.
+//
+// Layout, little endian:
+//   "SCLB", u8 version, 3 reserved bytes
+//   32 bytes a game: u64 deal number, u32 move count, u8 mode,
+//   u8 par status (Solver::Status), u16 par moves, u32 duration in
+//   milliseconds, 4 reserved bytes, u64 unix time the game was won
+class ScoreTable {
+public:
+  struct Entry {
+    std::uint64_t gameNumber{}; // position in the file, from 0
+    std::uint64_t dealNumber{};
+    std::uint32_t moveCount{};
+    Difficulty mode{};
+    // Unknown when the par wasn't ready as the game got registered
+    Solver::Status parStatus{Solver::Status::Unknown};
+    std::uint16_t par{};
+    std::chrono::milliseconds duration{};
+    std::uint64_t timestamp{}; // unix seconds
+
+    std::optional<long long> overPar() const; // only with a solved par
+  };
+
+  struct Ranking {
+    bool operator()(const Entry &a, const Entry &b) const;
+  };
+
+  // Iterators stay valid as games get added, so pages can be walked with
+  // upper_bound from the last entry shown
+  typedef std::set<Entry, Ranking> Ranked;
+
+  static constexpr size_t headerSize = 8;
+  static constexpr size_t recordSize = 32;
+
+public:
+  explicit ScoreTable(std::string path);
+
+  // gameNumber gets filled in. The entry stays in the indexes even when the
+  // file can't be written, it just won't be there next time.
+  std::expected<void, Error> add(Entry entry);
+  size_t size();
+
+  const Ranked &ranked();
+  // Empty when nobody won a game of the mode that week
+  const Ranked &ranked(Difficulty mode, std::int64_t week);
+  // The fewest moves of the deal, the earliest of those
+  std::optional<Entry> best(Difficulty mode, std::uint64_t dealNumber);
+  // Oldest first, index i is the i-th game that got loaded or added
+  const std::vector<Entry> &history();
+
+  // Weeks since the epoch, starting on Monday, UTC
+  static std::int64_t week(std::uint64_t timestamp);
+  static std::uint64_t now(); // unix seconds
+
+private:
+  void load();
+  void index(const Entry &entry);
+  // records is how many whole records the file has
+  std::expected<void, Error> openForAppend(std::uint64_t records);
+
+private:
+  std::string path_;
+  bool loaded_{};
+  // A file that isn't a leaderboard of a known version is left alone, after
+  // a failed write the game numbers would be off
+  bool readOnly_{};
+  std::uint64_t records_{}; // whole records in the file
+
+  Ranked ranked_;
+  std::map<std::pair<Difficulty, std::int64_t>, Ranked> weekly_;
+  // one map per mode, indexed by Difficulty
+  std::array<std::unordered_map<std::uint64_t, Entry>, 2> bestOnDeal_;
+  std::vector<Entry> history_;
+  std::ofstream out_; // opened with the first add
+};
+
+} // namespace solitairecpp
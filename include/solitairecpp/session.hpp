@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstdint>
+#include <expected>
+#include <solitairecpp/engine.hpp>
+#include <solitairecpp/error.hpp>
+#include <solitairecpp/move_log.hpp>
+
+namespace solitairecpp {
+
+class ErrorNothingToUndo : public ErrorBase {
+public:
+  std::string what() override { return "There is no move to undo"; }
+
+  Error error() override { return std::make_shared<ErrorNothingToUndo>(); }
+};
+
+class ErrorNothingToRedo : public ErrorBase {
+public:
+  std::string what() override { return "There is no move to redo"; }
+
+  Error error() override { return std::make_shared<ErrorNothingToRedo>(); }
+};
+
+// A single dealt game and it's move history. This is the whole api the core
+// library offers, the ui and the analysis tools are both built on top of it.
+class Session {
+public:
+  Session(Difficulty mode); // deals a random deal number
+  Session(Difficulty mode, std::uint64_t dealNumber,
+          size_t historyCapacity = MoveLog::defaultCapacity);
+  // A game restored from somewhere else, the history has to lead to state
+  Session(const GameState &state, MoveLog history, size_t moveCount);
+
+  // Seeded from std::random_device, once per game and not per shuffle
+  static std::uint64_t randomDealNumber();
+
+  const GameState &state() const;
+  std::expected<void, ErrorCode> apply(Move &move);
+  // Returns the move that got undone, so callers know what changed
+  std::expected<Move, ErrorCode> undo();
+  // Applies the last undone move again, gone as soon as a new move is applied
+  std::expected<Move, ErrorCode> redo();
+  bool canUndo() const;
+  bool canRedo() const;
+  size_t moveCount() const;
+  const MoveLog &history() const;
+
+private:
+  GameState state_;
+  MoveLog history_;
+  size_t moveCount_{};
+};
+
+} // namespace solitairecpp
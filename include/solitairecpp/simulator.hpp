@@ -0,0 +1,98 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <solitairecpp/engine.hpp>
+#include <solitairecpp/session.hpp>
+#include <solitairecpp/solver.hpp>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+namespace solitairecpp {
+
+// Plays whole games without the ui, to see how rule changes and strategies
+// play out over a lot of deals. Every move goes through Session::apply, the
+// same rules the board enforces. Deal i of a run is deal number i, so two
+// runs with different agents or rules play the same cards.
+//
+// Every thread fills it's own Stats and they get merged once at the end, the
+// threads share nothing but the counter handing out the games.
+class Simulator {
+public:
+  enum class Agent {
+    Random, // any legal move
+    Greedy, // the best ranked move to a position it hasn't seen yet
+    Solver, // plays the Solver's solution, gives up when there's none
+  };
+
+  struct Options {
+    std::uint64_t games{};
+    Difficulty mode{};
+    Agent agent{};
+    size_t threads{1};
+    Solver::Limits limits{}; // only for the solver agent
+    size_t maxMoves = 1'000; // a game that gets this long counts as lost
+  };
+
+  // Mergeable, the order games get added or merged in doesn't matter
+  struct Stats {
+    // moves of won games in buckets of moveBucketWidth, the last one takes
+    // everything longer
+    static constexpr size_t moveBucketWidth = 25;
+    static constexpr size_t moveBuckets = 20;
+    // game time, bucket i counts games that took less than 2^i microseconds
+    static constexpr size_t timeBuckets = 32;
+
+    std::uint64_t games{};
+    std::uint64_t wins{};
+    std::uint64_t wonMoves{}; // summed over the won games
+    std::array<std::uint64_t, moveBuckets> moves{};
+    std::chrono::nanoseconds time{}; // summed over all games
+    std::chrono::nanoseconds slowest{};
+    std::array<std::uint64_t, timeBuckets> times{};
+
+    void add(bool won, size_t moveCount, std::chrono::nanoseconds elapsed);
+    void merge(const Stats &other);
+
+    double winRate() const;
+    double averageMoves() const; // of the won games
+    // Upper bound of the bucket the given share of the games falls in
+    std::chrono::microseconds timePercentile(double share) const;
+  };
+
+  // Called on the calling thread about once a second
+  typedef std::function<void(std::uint64_t done, std::uint64_t total)>
+      Progress;
+
+public:
+  explicit Simulator(const Options &options);
+
+  Stats run(const Progress &progress = {});
+
+  static std::optional<Agent> parseAgent(std::string_view name);
+
+private:
+  // One thread's agent state, reused from game to game
+  struct Player {
+    Solver solver;
+    std::unordered_set<std::uint64_t> seen; // greedy only
+  };
+
+  // True when the game got won
+  bool play(Player &player, Session &session) const;
+  bool playRandom(Session &session) const;
+  bool playGreedy(Player &player, Session &session) const;
+  bool playSolver(Player &player, Session &session) const;
+
+private:
+  static constexpr std::uint64_t chunkSize_ = 64; // games handed out at once
+  static constexpr size_t noRecycleLimit_ = SIZE_MAX;
+  Options options_;
+};
+
+} // namespace solitairecpp
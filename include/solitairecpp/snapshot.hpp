@@ -0,0 +1,56 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <solitairecpp/engine.hpp>
+#include <solitairecpp/error.hpp>
+#include <solitairecpp/session.hpp>
+#include <string>
+#include <string_view>
+
+namespace solitairecpp {
+
+// A game in progress saved to disk, so quitting doesn't lose it. Loading puts
+// the cards straight into their piles, nothing gets dealt or replayed.
+//
+// Layout, little endian:
+//   "SCSN", u8 version, u8 mode, u16 recycles, u64 deal number,
+//   u32 move count, u32 undo size, u32 redo size, u8 size of every pile,
+//   3 reserved bytes, u32 journal records, u64 play time in milliseconds
+//   the 52 cards, pile by pile from the bottom, high bit set when face down
+//   the undo log oldest first, 4 bytes a move: from, to, count, flags
+//   u64 FNV-1a of everything before it
+class Snapshot {
+public:
+  static constexpr size_t headerSize = 56;
+
+  // What the game has outside the session. The journal gets cut back to the
+  // records the snapshot saw, a crash can leave it ahead of the snapshot.
+  struct Progress {
+    std::uint32_t journalRecords{};
+    std::chrono::milliseconds playTime{};
+  };
+  struct Loaded {
+    Session session;
+    Progress progress;
+  };
+
+  // encode and store in one go
+  static std::expected<void, Error> write(const std::string &path,
+                                          const Session &session,
+                                          const Progress &progress);
+  // Replaces the contents of out, which keeps it's capacity between calls
+  static void encode(const Session &session, const Progress &progress,
+                     std::string &out);
+  // Writes to a temporary file, fsyncs it and renames it over path. A crash
+  // at any point leaves either the old snapshot or the new one.
+  static std::expected<void, Error> store(const std::string &path,
+                                          std::string_view bytes);
+  static std::expected<Loaded, Error> load(const std::string &path);
+  // Size of the snapshot of session
+  static size_t size(const Session &session);
+};
+
+} // namespace solitairecpp
@@ -1,10 +1,22 @@
 #pragma once
 
 #include "solitairecpp/leaderboard.hpp"
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <solitairecpp/autosave.hpp>
 #include <solitairecpp/board.hpp>
 #include <solitairecpp/cards.hpp>
+#include <solitairecpp/cli.hpp>
+#include <solitairecpp/deal_database.hpp>
 #include <solitairecpp/error.hpp>
+#include <solitairecpp/journal.hpp>
 #include <solitairecpp/move_manager.hpp>
+#include <solitairecpp/par_pool.hpp>
+#include <solitairecpp/paths.hpp>
+#include <solitairecpp/session.hpp>
+#include <solitairecpp/snapshot.hpp>
+#include <solitairecpp/solver.hpp>
 
 namespace solitairecpp {
 
@@ -18,11 +30,19 @@ public:
 class Game {
 public:
   Game() = default;
+  Game(const Cli::Options &options);
   void Start();
+  // Plays the journal back on the board, movesPerSecond records a second
+  void Replay(const Journal &journal, double movesPerSecond);
 
 private:
   std::expected<void, Error> chooseModeScreen();
-  void mainLoop();
+  // Deals a new game unless there's one to resume
+  void mainLoop(std::optional<Snapshot::Loaded> resumed = std::nullopt);
+  std::optional<Snapshot::Loaded> loadSnapshot();
+  void openDealDatabase();
+  std::uint64_t nextDealNumber();
+  std::uint64_t winnableDealNumber() const;
 
 private:
   static const inline std::string splash_ = R"(
@@ -42,8 +62,28 @@ __  __               _       __            __
 
 )";
 
+  // Solving a deal takes a few milliseconds on average, these cap the slow
+  // ones so starting a game stays instant
+  static constexpr Solver::Limits dealSolverLimits_{
+      .memoryBytes = 8 << 20,
+      .maxNodes = 100'000,
+      .maxTime = std::chrono::milliseconds(100)};
+  static constexpr size_t maxDealAttempts_ = 16;
+  // Won by the solver and checked by replaying it's moves, for when none of
+  // the attempts above work out. Indexed by Difficulty.
+  static constexpr std::array<std::array<std::uint64_t, 16>, 2> provenDeals_{
+      {{4, 7, 8, 10, 11, 12, 13, 14, 16, 20, 21, 22, 23, 25, 26, 27},
+       {2, 3, 4, 5, 6, 8, 9, 10, 11, 13, 14, 15, 16, 17, 20, 21}}};
+
   Difficulty mode_{};
-  Leaderboard leaderboard_{};
+  std::optional<std::uint64_t> requestedDealNumber_;
+  bool analysis_{};
+  bool firstStart_{true};
+  std::optional<DealDatabase> deals_; // of mode_, if there is one
+  // before leaderboard_, which reads from it
+  ParPool par_{1, ParSolver::Limits{}, Paths::pars().string()};
+  Leaderboard leaderboard_{par_};
+  Autosave autosave_{Paths::snapshot().string()};
 };
 
 } // namespace solitairecpp
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <solitairecpp/engine.hpp>
+#include <solitairecpp/transposition_table.hpp>
+#include <stop_token>
+#include <vector>
+
+namespace solitairecpp {
+
+// Depth first search for a winning move list. Safe foundation moves are taken
+// without branching, moves that can't lead anywhere new are skipped and every
+// position seen goes into a transposition table, so each is searched once.
+// Unpromising moves are skipped too, which keeps the search small.
+//
+// Unsolvable is only reported when no unpromising move was skipped, so every
+// way of playing the deal got searched. Unknown means a limit hit first or
+// the skipped moves might have won.
+class Solver {
+public:
+  struct Limits {
+    size_t memoryBytes = 32 << 20; // for the transposition table
+    std::uint64_t maxNodes = 2'000'000;
+    std::chrono::milliseconds maxTime{2000};
+    size_t maxRecycles = 3;
+  };
+
+  enum class Status { Solved, Unsolvable, Unknown };
+
+  // What a move is good for, best first. Useless moves can't lead anywhere
+  // new, another order of the same moves gets searched. Unpromising ones
+  // could, but rarely do. Both get dropped.
+  enum class Rank : std::uint8_t {
+    Reveal,
+    Foundation,
+    EmptyRow,
+    FromWaste,
+    Shuffle, // partial run moves that expose something useful
+    Draw,
+    Unpromising, // splits that free nothing, draws past maxRecycles
+    Useless,
+  };
+
+  struct Result {
+    Status status{Status::Unknown};
+    std::vector<Move> moves; // only when solved, from the given position
+    std::uint64_t nodes{};
+    std::chrono::duration<double> elapsed{};
+  };
+
+public:
+  Solver();
+  explicit Solver(const Limits &limits);
+
+  // The table is reused between calls, it gets cleared before every solve. A
+  // stop request makes it return Unknown soon after.
+  Result solve(const GameState &state, std::stop_token stop = {});
+
+  // Orders the generated moves best first and drops the useless and
+  // unpromising ones. Returns how many are left at the front of moves.
+  // afterDraw tells if the position was reached by drawing. cut gets set when
+  // an unpromising move was dropped, a search that ran dry after that didn't
+  // prove the deal unsolvable.
+  static size_t candidates(const GameState &state, GameState::MoveList &moves,
+                           bool afterDraw, size_t maxRecycles, bool &cut);
+  static Rank rank(const GameState &state, const Move &move, bool afterDraw,
+                   size_t maxRecycles);
+  // What goes into the transposition table for a position
+  static std::uint64_t tableKey(const GameState &state, bool afterDraw);
+
+private:
+  struct Frame {
+    size_t offset; // of the candidates in moves_
+    size_t count;
+    size_t next{};
+  };
+
+  Limits limits_;
+  TranspositionTable table_;
+  // candidates of every frame on the stack, back to back
+  std::vector<Move> moves_;
+  std::vector<Frame> frames_;
+};
+
+} // namespace solitairecpp
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace solitairecpp {
+
+// Set of position hashes seen by a search, sized by a memory budget. Buckets
+// are 4 hashes (half a cache line), a full bucket evicts one of them. Losing
+// an entry only costs searching that position again, never a wrong answer.
+//
+// Lock free, so searching threads can share one. Empty slots get claimed with
+// a compare exchange; two threads inserting the same hash at once may both
+// get true, which again only costs a repeated search.
+//
+// The low byte of every entry holds the generation it was written in, clear()
+// only bumps the generation and entries of older ones count as empty. That
+// keeps clearing free, solving many deals one after another depends on it.
+class TranspositionTable {
+public:
+  explicit TranspositionTable(size_t bytes);
+
+  // True if the hash wasn't in the table yet, it is afterwards
+  bool insert(std::uint64_t hash);
+  // For searches that can reach a position again on a shorter path. True if
+  // the hash wasn't in the table with a depth of at most depth, and stores
+  // depth for it. Entries keep only the top 40 bits of the hash to make room,
+  // so a table is used either with insert or with improve.
+  bool improve(std::uint64_t hash, std::uint16_t depth);
+  // Not safe while other threads insert
+  void clear();
+  size_t capacity() const; // in hashes
+
+private:
+  static constexpr size_t bucketSize_ = 4;
+  static constexpr std::uint64_t generationMask_ = 0xFF;
+  static constexpr int depthShift_ = 8;
+  static constexpr std::uint64_t keyMask_ = ~std::uint64_t{0xFFFFFF};
+  std::vector<std::atomic<std::uint64_t>> entries_;
+  size_t mask_{}; // bucket count - 1, the count is a power of two
+  std::uint64_t generation_{1}; // 0 is for entries never written
+
+  static_assert(std::atomic<std::uint64_t>::is_always_lock_free);
+};
+
+} // namespace solitairecpp
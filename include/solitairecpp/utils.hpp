@@ -2,6 +2,7 @@
 
 #include <ftxui/component/component.hpp>
 #include <ftxui/dom/elements.hpp>
+#include <functional>
 #include <string>
 
 namespace ft = ftxui;
@@ -13,6 +14,11 @@ public:
 
   static ft::ComponentDecorator exitListener();
 
+  // Queues the task on the ui loop and asks for a redraw once it ran. Every
+  // click that touches the game goes through here, so moves are applied one
+  // at a time, in click order, on the same thread that renders them.
+  static void post(std::function<void()> task);
+
   static const inline ft::LinearGradient headerGradient =
       ft::LinearGradient()
           .Angle(45)
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <solitairecpp/engine.hpp>
+#include <solitairecpp/solver.hpp>
+#include <stop_token>
+#include <thread>
+#include <vector>
+
+namespace solitairecpp {
+
+// Chance to win a position, from rollouts: the hidden cards get dealt at
+// random (GameState::sample) and a Solver with a small node budget tries to
+// win the result. Rollouts it can't decide in time count as lost, so the
+// estimate leans low.
+//
+// A pool of threads does the rollouts. estimate() hands it a new position and
+// stops the rollouts of the old one through their stop_token. The counts
+// start over and grow as rollouts come in, readers see it refine.
+class WinEstimator {
+public:
+  struct Estimate {
+    std::uint64_t wins{};
+    std::uint64_t rollouts{};
+
+    double probability() const; // 0 before the first rollout is in
+  };
+
+  // Called on a pool thread every few rollouts and when the last one is in
+  typedef std::function<void()> Progress;
+
+  static constexpr Solver::Limits rolloutLimits{.memoryBytes = 1 << 20,
+                                                .maxNodes = 2'000};
+
+public:
+  WinEstimator(size_t threads, size_t maxRollouts = 4'096,
+               const Solver::Limits &limits = rolloutLimits,
+               Progress progress = {});
+  ~WinEstimator();
+
+  void estimate(const GameState &state);
+  void stop(); // the pool idles until the next estimate
+  Estimate current() const;
+
+private:
+  void run(std::stop_token stop);
+
+private:
+  static constexpr std::uint64_t progressInterval_ = 128;
+
+  Solver::Limits limits_;
+  size_t maxRollouts_;
+  Progress progress_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable_any wake_;
+  GameState state_;
+  bool active_{};
+  std::uint64_t generation_{}; // one per estimate() call
+  std::uint64_t started_{};    // rollouts handed out for this position
+  std::stop_source position_;  // stopped as soon as the position changes
+  Estimate estimate_;
+  std::vector<std::jthread> threads_;
+};
+
+} // namespace solitairecpp
@@ -1,6 +1,200 @@
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <print>
+#include <solitairecpp/batch_solver.hpp>
+#include <solitairecpp/cli.hpp>
+#include <solitairecpp/deal_database.hpp>
+#include <solitairecpp/journal.hpp>
+#include <solitairecpp/paths.hpp>
+#include <solitairecpp/simulator.hpp>
 #include <solitairecpp/solitairecpp.hpp>
+#include <thread>
 
-int main() {
-  solitairecpp::Game game;
+namespace {
+
+using namespace solitairecpp;
+
+size_t threadCount(const Cli::Options &options) {
+  return options.threads.value_or(
+      std::max(1u, std::thread::hardware_concurrency()));
+}
+
+int solveRange(const Cli::Options &options) {
+  Solver::Limits limits;
+  if (options.maxNodes)
+    limits.maxNodes = options.maxNodes.value();
+
+  const auto path = options.output.value_or("solve-range.csv");
+  BatchSolver solver({.from = options.solveRange->from,
+                      .to = options.solveRange->to,
+                      .mode = options.mode,
+                      .threads = threadCount(options),
+                      .limits = limits,
+                      .path = path});
+  auto summary = solver.run([](std::uint64_t done, std::uint64_t total) {
+    std::print(stderr, "\r{}/{} deals", done, total);
+  });
+  std::print(stderr, "\n");
+  if (!summary) {
+    std::print(stderr, "{}\n", summary.error()->what());
+    return 1;
+  }
+
+  std::print("{} solved, {} unsolvable, {} unknown, {} already in {}\n",
+             summary->solved, summary->unsolvable, summary->unknown,
+             summary->skipped, path);
+  return 0;
+}
+
+int buildDealDatabase(const Cli::Options &options) {
+  auto results = BatchSolver::read(options.buildDealDatabase.value());
+  if (!results) {
+    std::print(stderr, "{}\n", results.error()->what());
+    return 1;
+  }
+
+  DealDatabase::Buckets buckets;
+  for (const auto &record : results->records)
+    if (record.status == Solver::Status::Solved)
+      buckets[static_cast<size_t>(DealDatabase::rate(record.nodes))]
+          .push_back(record.deal);
+
+  const auto path = options.output.value_or(
+      Paths::dealDatabase(results->mode).string());
+  auto written = DealDatabase::write(path, results->mode, std::move(buckets));
+  if (!written) {
+    std::print(stderr, "{}\n", written.error()->what());
+    return 1;
+  }
+
+  auto database = DealDatabase::open(path);
+  if (!database) {
+    std::print(stderr, "{}\n", database.error()->what());
+    return 1;
+  }
+  std::print("{} winnable deals ({} quick, {} medium, {} long) in {}, {} "
+             "bytes\n",
+             database->size(), database->size(DealDatabase::Rating::Quick),
+             database->size(DealDatabase::Rating::Medium),
+             database->size(DealDatabase::Rating::Long), path,
+             std::filesystem::file_size(path));
+  return 0;
+}
+
+int simulate(const Cli::Options &options) {
+  Solver::Limits limits;
+  if (options.maxNodes)
+    limits.maxNodes = options.maxNodes.value();
+
+  Simulator simulator({.games = options.simulate.value(),
+                       .mode = options.mode,
+                       .agent = options.agent,
+                       .threads = threadCount(options),
+                       .limits = limits});
+  const auto start = std::chrono::steady_clock::now();
+  const auto stats =
+      simulator.run([](std::uint64_t done, std::uint64_t total) {
+        std::print(stderr, "\r{}/{} games", done, total);
+      });
+  const std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+  std::print(stderr, "\n");
+
+  std::print("{} of {} games won, {:.2f}%, {:.0f} games/s\n", stats.wins,
+             stats.games, 100 * stats.winRate(),
+             stats.games / elapsed.count());
+  if (stats.wins != 0) {
+    std::print("moves of the won games, {:.1f} on average:\n",
+               stats.averageMoves());
+    for (size_t i{}; i < stats.moves.size(); i++) {
+      if (stats.moves[i] == 0)
+        continue;
+      const auto from = i * Simulator::Stats::moveBucketWidth;
+      if (i + 1 == stats.moves.size())
+        std::print("  {:>4}+     {}\n", from, stats.moves[i]);
+      else
+        std::print("  {:>4}-{:<4} {}\n", from,
+                   from + Simulator::Stats::moveBucketWidth - 1,
+                   stats.moves[i]);
+    }
+  }
+
+  using std::chrono::microseconds;
+  const auto average = std::chrono::duration_cast<microseconds>(
+      stats.time / std::max<std::uint64_t>(1, stats.games));
+  std::print("game time: {} us average, under {} us median, under {} us p99, "
+             "{} us slowest\n",
+             average.count(), stats.timePercentile(0.5).count(),
+             stats.timePercentile(0.99).count(),
+             std::chrono::duration_cast<microseconds>(stats.slowest).count());
+  return 0;
+}
+
+// Headless the journal is checked record by record, a record that doesn't
+// apply is where a bug report starts
+int replay(const Cli::Options &options) {
+  auto journal = Journal::open(options.replay.value());
+  if (!journal) {
+    std::print(stderr, "{}\n", journal.error()->what());
+    return 1;
+  }
+  if (options.speed) {
+    Game game(options);
+    game.Replay(journal.value(), static_cast<double>(options.speed.value()));
+    return 0;
+  }
+
+  const auto start = std::chrono::steady_clock::now();
+  Session session(journal->mode(), journal->dealNumber());
+  for (size_t i{}; i < journal->size(); i++) {
+    const auto record = journal->at(i);
+    if (!record) {
+      std::print(stderr, "record {} is corrupt\n", i);
+      return 1;
+    }
+    auto success = Journal::replay(session, record.value());
+    if (!success) {
+      std::print(stderr, "record {} failed: {}\n", i,
+                 toError(success.error())->what());
+      return 1;
+    }
+  }
+  const std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+
+  std::print("deal {} ({}), {} records replayed in {:.3f} ms, {:.0f} "
+             "records/s\n",
+             journal->dealNumber(),
+             journal->mode() == Difficulty::Easy ? "easy" : "hard",
+             journal->size(), elapsed.count() * 1000,
+             journal->size() / elapsed.count());
+  std::print("ends at move {}, {}\n", session.moveCount(),
+             session.state().won() ? "won" : "not won");
+  return 0;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  auto options = Cli::parse(argc, argv);
+  if (!options) {
+    std::print(stderr, "{}\n{}", options.error()->what(), Cli::usage());
+    return 1;
+  }
+  if (options->help) {
+    std::print("{}", Cli::usage());
+    return 0;
+  }
+  if (options->solveRange)
+    return solveRange(options.value());
+  if (options->buildDealDatabase)
+    return buildDealDatabase(options.value());
+  if (options->simulate)
+    return simulate(options.value());
+  if (options->replay)
+    return replay(options.value());
+
+  Game game(options.value());
   game.Start();
 }
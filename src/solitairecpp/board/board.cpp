@@ -1,12 +1,14 @@
 #include <algorithm>
+#include <format>
 #include <ftxui/component/component.hpp>
 #include <ftxui/component/screen_interactive.hpp>
 #include <ftxui/dom/elements.hpp>
 #include <memory>
-#include <random>
+#include <solitairecpp/auto_complete.hpp>
 #include <solitairecpp/board.hpp>
 #include <solitairecpp/move_manager.hpp>
 #include <solitairecpp/utils.hpp>
+#include <thread>
 
 namespace solitairecpp {
 
@@ -23,40 +25,52 @@ ft::Component ExitButton::component() {
   });
 }
 
-Board::Board(Difficulty mode, GameCallbacks callbacks)
-    : moveManager_{std::make_unique<MoveManager>(*this)},
-      gameCallbacks_{callbacks} {
-  Cards deck = buildDeck();
-
-  Tableau::StartCards tabelauCards =
-      [&]<std::size_t... Is>(std::index_sequence<Is...>) {
-        return Tableau::StartCards{{deck.at(Is)...}};
-      }(std::make_index_sequence<
-          Tableau::startCardsSize>{}); // This is just initializing the array
-                                       // with elements from the deck. Yes
-                                       // there is problably no other simpler
-                                       // way.
-  tableau_ = std::make_unique<Tableau>(tabelauCards, *moveManager_);
-  deck.erase(deck.begin(), deck.begin() + Tableau::startCardsSize);
-
-  ReserveStack::StartCards reserveStackCards =
-      [&]<std::size_t... Is>(std::index_sequence<Is...>) {
-        return ReserveStack::StartCards{{deck.at(Is)...}};
-      }(std::make_index_sequence<ReserveStack::startCardsSize>{});
-  reserveStack_ =
-      std::make_unique<ReserveStack>(mode, *moveManager_, reserveStackCards);
-
-  foundations_ =
-      std::make_unique<Foundations>(*moveManager_, gameCallbacks_.onGameWon);
+Board::Board(Session session, GameCallbacks callbacks, bool analysis,
+             JournalWriter *journal)
+    : session_{std::move(session)},
+      moveManager_{std::make_unique<MoveManager>(*this)},
+      cardCache_{std::make_unique<CardCache>(*moveManager_)},
+      tableau_{std::make_unique<Tableau>(*moveManager_)},
+      reserveStack_{
+          std::make_unique<ReserveStack>(session_.state(), *moveManager_)},
+      foundations_{std::make_unique<Foundations>(*moveManager_)},
+      journal_{journal}, gameCallbacks_{callbacks} {
+  for (PileId pile{}; pile < Piles::count; pile++)
+    syncPile(pile);
+
+  if (analysis) {
+    // one core stays free for the ui
+    const size_t threads =
+        std::max(2u, std::thread::hardware_concurrency()) - 1;
+    estimator_ = std::make_unique<WinEstimator>(
+        threads, analysisRollouts_, WinEstimator::rolloutLimits,
+        [] { utils::post([] {}); }); // only to redraw
+  }
+  positionChanged();
 }
 
 ft::Component Board::component() const {
   auto moveCounter = ft::Renderer([&] {
-    return ft::text("Move count: " + std::to_string(moveManager_->moveCount()));
+    auto counter = ft::vbox(
+        ft::text("Deal #" + std::to_string(session_.state().dealNumber())),
+        ft::text("Move count: " + std::to_string(moveManager_->moveCount())));
+    if (!estimator_)
+      return counter;
+
+    const auto estimate = estimator_->current();
+    const auto chance = static_cast<float>(estimate.probability());
+    return ft::vbox(
+        counter,
+        ft::hbox(ft::text("Win chance "),
+                 ft::gauge(chance) | ft::size(ft::WIDTH, ft::EQUAL, 20),
+                 ft::text(std::format(" {:.0f}% of {} rollouts",
+                                      100 * chance, estimate.rollouts))));
   });
   auto sidepanel = ft::Container::Vertical(
       {foundations_->component(), reserveStack_->component(), moveCounter,
-       moveManager_->rollbackButton(),
+       ft::Container::Horizontal(
+           {moveManager_->rollbackButton(), moveManager_->redoButton(),
+            moveManager_->hintButton(), moveManager_->autoCompleteButton()}),
        ft::Button("View leaderboard", gameCallbacks_.viewLeadearBoard,
                   ft::ButtonOption::Border()),
        ft::Button("Restart game", gameCallbacks_.restartGame,
@@ -80,50 +94,118 @@ ft::Component Board::component() const {
          moveManager_->moveTransactionCanceledListener();
 }
 
-Cards Board::buildDeck() {
-  const auto deckSize = 52;
-  Cards deck;
-  ArtGenerator generator;
-  deck.reserve(deckSize);
-  for (size_t i{}; i < static_cast<size_t>(CardValue::Count); i++) {
-    for (size_t j{}; j < static_cast<size_t>(CardType::Count); j++) {
-      auto value = static_cast<CardValue>(i);
-      auto type = static_cast<CardType>(j);
-      deck.emplace_back(*moveManager_, value, type,
-                        generator.generate(value, type));
-    }
-  }
+std::expected<CardPosition, Error> Board::search(const CardCode &code) const {
+  const auto &state = session_.state();
+  const auto [pile, depth] = state.locate(code);
+  if (Piles::isTableau(pile))
+    return Tableau::CardPosition{.cardRowIndex = pile, .cardIndex = depth};
 
-  std::random_device rd;
-  std::mt19937 gen{rd()};
+  // only the cards that are shown can be found
+  if (pile == Piles::waste &&
+      depth >= state.waste().size() - state.viewableWasteSize())
+    return ReserveStack::CardPosition{};
 
-  std::shuffle(deck.begin(), deck.end(), gen);
+  if (Piles::isFoundation(pile) && depth == state.pileSize(pile) - 1)
+    return Foundations::CardPosition{.foundationIndex =
+                                         Piles::foundationIndex(pile)};
 
-  return deck;
+  return std::unexpected(ErrorCardPositionNotFound(code).error());
 }
 
-std::expected<CardPosition, Error> Board::search(const CardCode &code) const {
-  auto tableauPos = tableau_->search(code);
-  if (tableauPos)
-    return tableauPos.value();
+std::expected<void, ErrorCode> Board::apply(Move &move) {
+  auto success = session_.apply(move);
+  if (!success)
+    return std::unexpected(success.error());
 
-  auto reserveStackPos = reserveStack_->searchViewable(code);
-  if (reserveStackPos)
-    return reserveStackPos.value();
+  record({.kind = Journal::Kind::Apply, .move = move});
+  syncMove(move);
+  if (session_.state().won())
+    gameCallbacks_.onGameWon();
+  return std::expected<void, ErrorCode>();
+}
 
-  auto foundationsStackPos = foundations_->search(code);
-  if (foundationsStackPos)
-    return foundationsStackPos.value();
+std::expected<void, ErrorCode> Board::undo() {
+  auto move = session_.undo();
+  if (!move)
+    return std::unexpected(move.error());
 
-  return std::unexpected(ErrorCardPositionNotFound(code).error());
+  record({.kind = Journal::Kind::Undo});
+  syncMove(move.value());
+  return std::expected<void, ErrorCode>();
+}
+
+std::expected<void, ErrorCode> Board::redo() {
+  auto move = session_.redo();
+  if (!move)
+    return std::unexpected(move.error());
+
+  record({.kind = Journal::Kind::Redo});
+  syncMove(move.value());
+  if (session_.state().won())
+    gameCallbacks_.onGameWon();
+  return std::expected<void, ErrorCode>();
+}
+
+size_t Board::autoComplete() {
+  const auto moves = AutoComplete::run(session_);
+  std::uint16_t touched{};
+  for (const auto &move : moves) {
+    record({.kind = Journal::Kind::Apply, .move = move});
+    hints_.touched(move);
+    touched |= static_cast<std::uint16_t>(1 << move.from | 1 << move.to);
+  }
+  for (PileId pile{}; pile < Piles::count; pile++)
+    if (touched & (1 << pile))
+      syncPile(pile);
+
+  positionChanged();
+  if (session_.state().won())
+    gameCallbacks_.onGameWon();
+  return moves.size();
+}
+
+void Board::syncMove(const Move &move) {
+  hints_.touched(move);
+  syncPile(move.from);
+  syncPile(move.to);
+  positionChanged();
+}
+
+void Board::record(const Journal::Record &record) {
+  if (journal_)
+    journal_->record(record);
 }
 
-Tableau &Board::tableau() const { return *tableau_; }
+// the rollouts of the old position get stopped right away
+void Board::positionChanged() {
+  if (gameCallbacks_.onChanged)
+    gameCallbacks_.onChanged(session_);
+  if (!estimator_)
+    return;
+  if (session_.state().won())
+    estimator_->stop();
+  else
+    estimator_->estimate(session_.state());
+}
+
+void Board::syncPile(PileId pile) {
+  const auto &state = session_.state();
+  if (Piles::isTableau(pile))
+    tableau_->sync(pile, state, *cardCache_);
+  else if (Piles::isFoundation(pile))
+    foundations_->sync(Piles::foundationIndex(pile), state, *cardCache_);
+  else
+    reserveStack_->sync(state, *cardCache_);
+}
+
+const GameState &Board::state() const { return session_.state(); }
+
+const Session &Board::session() const { return session_; }
 
-ReserveStack &Board::reserveStack() const { return *reserveStack_; }
+size_t Board::moveCount() const { return session_.moveCount(); }
 
-Foundations &Board::foundations() const { return *foundations_; }
+std::optional<Move> Board::hint() { return hints_.best(session_.state()); }
 
-size_t Board::moveCount() const { return moveManager_->moveCount(); }
+void Board::clearCardElements() { cardCache_->clearElements(); }
 
 } // namespace solitairecpp
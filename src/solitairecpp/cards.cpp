@@ -1,192 +1,152 @@
 #include <ftxui/component/component.hpp>
 #include <ftxui/component/screen_interactive.hpp>
 #include <ftxui/dom/elements.hpp>
-#include <print>
+#include <solitairecpp/board.hpp>
 #include <solitairecpp/cards.hpp>
 #include <solitairecpp/error.hpp>
 #include <solitairecpp/move_manager.hpp>
+#include <solitairecpp/utils.hpp>
 #include <unordered_map>
 
 namespace solitairecpp {
 
-bool CardCode::operator==(const CardCode &rhs) const {
-  return value == rhs.value && type == rhs.type;
-}
-
-Card::Card(MoveManager &moveManager, CardValue value, CardType type,
-           std::string art, bool hidden)
-    : moveManager_{moveManager}, value_{value}, type_{type}, art_{art},
-      hidden_{std::make_shared<bool>(hidden)} {
-  if (type_ == CardType::Hearts || type_ == CardType::Diamonds)
-    color_ = CardColor::Red;
-  else
-    color_ = CardColor::Black;
+Card::Card(MoveManager &moveManager, CardCode code, std::string art)
+    : moveManager_{moveManager}, code_{code},
+      color_{PackedCard(code).color()}, art_{art} {
   component_ = ft::Button(
-      {.on_click =
-           [=, *this] {
-             if (*hidden_)
-               return;
-
-             std::thread([*this] {
-               moveManager_.cardSelected(code());
-             }).detach();
-           },
-       .transform =
-           [=, *this](const ft::EntryState state) {
-             auto element =
-                 ft::text(*hidden_ ? backsideArt_ : art_) | ft::center;
-             element |= cardWidth | cardHeight;
-             element |= ft::border;
-
-             if (!*hidden_) {
-               switch (color_) {
-               case CardColor::Red:
-                 element |= ft::color(ft::Color::Red);
-                 break;
-               case CardColor::Black:
-                 element |= ft::color(ft::Color::GrayDark);
-                 break;
-               }
-             }
-
-             // shoud not focus if the transaction is open or the
-             // card is hidden, unless we are targetable;
-             if (moveManager_.moveTransactionOpen() || *hidden_)
-               return element;
-
-             if (state.active) {
-               element |= ft::bold;
-             }
-             if (state.focused) {
-               element |= ft::inverted;
-             }
-             return element;
-           }});
+      {.on_click = [this] { onClick(); },
+       .transform = [this](const ft::EntryState &state) {
+         return render(state);
+       }});
 }
 
-Card &Card::operator=(const Card &other) {
-  if (this == &other)
-    return *this;
-
-  value_ = other.value_;
-  type_ = other.type_;
-  art_ = other.art_;
-  hidden_ = other.hidden_;
-  component_ = other.component_;
-  color_ = other.color_;
-  return *this;
+void Card::onClick() {
+  switch (section_) {
+  case BoardSection::Tableau:
+  case BoardSection::ReserveStack:
+    if (hidden_ || !selectable_)
+      return;
+
+    utils::post([this] { moveManager_.cardSelected(code_); });
+    break;
+  case BoardSection::Foundations:
+    utils::post([this] { moveManager_.setMoveTarget(code_); });
+    break;
+  }
 }
 
-void Card::showWithoutStatusChange() { *hidden_ = false; }
+// Called for every card on every frame, so this only works out which look
+// the card has. The text, size, border and colors of it are built once.
+ft::Element Card::render(const ft::EntryState &state) const {
+  size_t look{};
+  if (hidden_)
+    look |= lookHidden;
+  if (selectable_ && moveManager_.isHint(code_))
+    look |= lookHint;
+
+  bool focusable{};
+  switch (section_) {
+  case BoardSection::Tableau:
+    // shoud not focus if the transaction is open or the
+    // card is hidden, unless we are targetable;
+    focusable = !moveManager_.moveTransactionOpen() && !hidden_;
+    break;
+  case BoardSection::ReserveStack:
+    focusable = selectable_;
+    break;
+  case BoardSection::Foundations:
+    focusable = moveManager_.moveTransactionOpen();
+    break;
+  }
+  if (focusable && state.active)
+    look |= lookActive;
+  if (focusable && state.focused)
+    look |= lookFocused;
+
+  auto &element = elements_[look];
+  if (!element)
+    element = build(look);
+  return element;
+}
 
-void Card::show() {
-  if (*hidden_) { // To presereve hiddenStatusChanged
-    hiddenStatusChanged = true;
-    *hidden_ = false;
+ft::Element Card::build(size_t look) const {
+  const bool hidden = look & lookHidden;
+  auto element = ft::text(hidden ? backsideArt_ : art_) | ft::center;
+  element |= cardWidth | cardHeight;
+  element |= ft::border;
+  // the innermost color wins, so this goes before the suit's
+  if (look & lookHint)
+    element |= ft::color(ft::Color::Yellow);
+
+  if (!hidden) {
+    switch (color_) {
+    case CardColor::Red:
+      element |= ft::color(ft::Color::Red);
+      break;
+    case CardColor::Black:
+      element |= ft::color(ft::Color::GrayDark);
+      break;
+    }
   }
+
+  if (look & lookActive)
+    element |= ft::bold;
+  if (look & lookFocused)
+    element |= ft::inverted;
+  return element;
 }
 
-void Card::hideRollback() {
-  if (hiddenStatusChanged) // Only when a card's status was changed by the user
-                           // we can hide it again
-    *hidden_ = true;
+void Card::place(BoardSection section, bool hidden, bool selectable) {
+  section_ = section;
+  hidden_ = hidden;
+  selectable_ = selectable;
 }
 
-ft::Component Card::component() const { return std::move(component_); }
+ft::Component Card::component() const { return component_; }
 
-CardCode Card::code() const { return {.value = value_, .type = type_}; }
+CardCode Card::code() const { return code_; }
 
 CardColor Card::color() const { return color_; }
 
-CardRow::CardRow(size_t index, MoveManager &moveManager)
-    : cardsComponent_{ft::Container::Vertical({})}, moveManager_{moveManager},
-      index_{index} {}
-
-bool CardRow::isAppendLegal(const Cards &tobeappended) {
-  if (tobeappended.empty())
-    return false; // empty sequence should not get appended
-
-  // only sequence starting with a king can get appened
-  if (cards_.empty() && tobeappended.front().code().value != CardValue::King)
-    return false;
-
-  // the first one can't be the same color
-  if (!cards_.empty() && cards_.back().color() == tobeappended.front().color())
-    return false;
-
-  // value needs to be lower than previous if's ace there will never be a card
-  // with -1 index, so everything works out
-  if (!cards_.empty() &&
-      static_cast<int>(cards_.back().code().value) - 1 !=
-          static_cast<int>(tobeappended.front().code().value))
-    return false;
-
-  if (tobeappended.size() == 1)
-    return true; // nothing left to validate
-
-  auto previousColor = tobeappended.front().color();
-  auto previousValue = tobeappended.front().code().value;
-  for (size_t i{1}; i < tobeappended.size(); i++) {
-    const auto &card = tobeappended.at(i);
-    if (static_cast<int>(card.code().value) !=
-        static_cast<int>(previousValue) - 1)
-      return false;
-
-    if (card.color() == previousColor)
-      return false;
-
-    previousValue = card.code().value;
-    previousColor = card.color();
-  }
-
-  return true; // finally
-}
+bool Card::hidden() const { return hidden_; }
 
-void CardRow::appendCore(const Cards &cards) {
-  if (cards_.size() == 0 && cardsComponent_->ChildCount() == 1)
-    cardsComponent_->DetachAllChildren(); // remove dummy
+void Card::clearElements() { elements_.fill(nullptr); }
 
-  cards_.reserve(cards.size());
-  for (const auto &card : cards) {
-    cards_.emplace_back(card);
-    cardsComponent_->Add(card.component());
+CardCache::CardCache(MoveManager &moveManager) {
+  ArtGenerator generator;
+  for (size_t i{}; i < cards_.size(); i++) {
+    const auto code = PackedCard::fromIndex(i).code();
+    cards_[i] = std::make_unique<Card>(
+        moveManager, code, generator.generate(code.value, code.type));
   }
 }
 
-std::expected<void, Error> CardRow::append(const Cards &cards) {
-  if (!isAppendLegal(cards))
-    return std::unexpected(ErrorIllegalMove().error());
+Card &CardCache::at(PackedCard card) const { return *cards_[card.index()]; }
 
-  appendCore(cards);
-  return std::expected<void, Error>();
+void CardCache::clearElements() {
+  for (auto &card : cards_)
+    card->clearElements();
 }
 
-void CardRow::appendRollback(const Cards &cards) {
-  if (!cards_.empty())
-    cards_.back().hideRollback(); // Hide the previous one
-
-  appendCore(cards);
-}
-
-std::expected<void, Error> CardRow::deleteFrom(const CardPosition &pos) {
-  if (pos.cardIndex >= cards_.size())
-    return std::unexpected(ErrorInvalidCardIndex().error());
-
-  for (size_t i{pos.cardIndex}; i < cards_.size(); i++)
-    cardsComponent_->ChildAt(pos.cardIndex)->Detach();
+CardRow::CardRow(size_t index, MoveManager &moveManager)
+    : cardsComponent_{ft::Container::Vertical({})}, index_{index},
+      moveManager_{moveManager} {}
 
-  cards_.erase(cards_.begin() + pos.cardIndex, cards_.end());
+void CardRow::sync(const GameState::TableauRow &row, const CardCache &cache) {
+  cardsComponent_->DetachAllChildren();
+  size_ = row.size();
 
-  if (!cards_.empty())
-    cards_.back().show(); // Reveal the last card
+  for (const auto card : row) {
+    auto &cardView = cache.at(card);
+    cardView.place(BoardSection::Tableau, card.faceDown());
+    cardsComponent_->Add(cardView.component());
+  }
 
-  if (cards_.empty()) {
+  if (row.empty()) {
     // Add dummy so that "Empty container" doesn't get displayed
     cardsComponent_->Add(
         ft::Renderer([] { return ft::emptyElement() | Card::cardWidth; }));
   }
-
-  return std::expected<void, Error>();
 }
 
 ft::Component CardRow::component() const {
@@ -195,14 +155,19 @@ ft::Component CardRow::component() const {
            [this] {
              if (!moveManager_.moveTransactionOpen())
                return;
-             moveManager_.setMoveTarget(Tableau::CardPosition{
-                 .cardRowIndex = index_,
-                 .cardIndex = cards_.size()}); // will point to the card that's
-                                               // about to beadded
+             utils::post([this] {
+               moveManager_.setMoveTarget(Tableau::CardPosition{
+                   .cardRowIndex = index_,
+                   .cardIndex = size_}); // will point to the card that's
+                                         // about to beadded
+             });
            },
        .transform =
            [this](const ft::EntryState &state) {
              auto element = ft::separator();
+             if (moveManager_.isHint(Tableau::CardPosition{
+                     .cardRowIndex = index_, .cardIndex = size_}))
+               element |= ft::color(ft::Color::Yellow);
 
              // should not focus if transaction is not open
              if (!moveManager_.moveTransactionOpen())
@@ -214,7 +179,7 @@ ft::Component CardRow::component() const {
                element |= ft::inverted;
 
              if (moveManager_.isTargetError(Tableau::CardPosition{
-                     .cardRowIndex = index_, .cardIndex = cards_.size()}))
+                     .cardRowIndex = index_, .cardIndex = size_}))
                element |= ft::color(ft::Color::Red);
 
              return element | ft::color(ft::Color::Green);
@@ -222,25 +187,6 @@ ft::Component CardRow::component() const {
   return std::move(ft::Container::Vertical({cardsComponent_, moveTargetBar}));
 }
 
-std::expected<CardRow::CardPosition, Error>
-CardRow::search(const CardCode &code) const {
-  for (const auto [i, card] :
-       std::views::zip(std::views::iota(0ULL), cards_)) { // C++23 baby
-    if (code == card.code())
-      return CardPosition{.cardIndex = i};
-  }
-
-  return std::unexpected(ErrorCardPositionNotFound(code).error());
-}
-
-std::expected<Cards, Error> CardRow::getCardsFrom(const CardPosition &pos) {
-  if (pos.cardIndex >= cards_.size())
-    return std::unexpected(ErrorInvalidCardIndex().error());
-
-  Cards res(cards_.begin() + pos.cardIndex, cards_.end());
-  return res;
-}
-
 std::string ArtGenerator::generate(CardValue value, CardType type) {
   return valueStr.at(value) + " " + typeStr.at(type);
 }
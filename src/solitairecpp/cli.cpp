@@ -0,0 +1,167 @@
+#include <charconv>
+#include <solitairecpp/cli.hpp>
+
+namespace solitairecpp {
+
+std::expected<Cli::Options, Error> Cli::parse(int argc, char **argv) {
+  Options options;
+  for (int i{1}; i < argc; i++) {
+    const std::string arg = argv[i];
+    if (arg == "--help" || arg == "-h") {
+      options.help = true;
+    } else if (arg == "--analysis") {
+      options.analysis = true;
+    } else if (arg == "--deal") {
+      auto number = numberValue(i, argc, argv);
+      if (!number)
+        return std::unexpected(number.error());
+      options.dealNumber = number.value();
+    } else if (arg == "--solve-range") {
+      auto from = numberValue(i, argc, argv);
+      if (!from)
+        return std::unexpected(from.error());
+      auto to = numberValue(i, argc, argv);
+      if (!to)
+        return std::unexpected(to.error());
+      options.solveRange = DealRange{.from = from.value(), .to = to.value()};
+    } else if (arg == "--build-deal-db") {
+      auto results = value(i, argc, argv);
+      if (!results)
+        return std::unexpected(results.error());
+      options.buildDealDatabase = results.value();
+    } else if (arg == "--simulate") {
+      auto games = numberValue(i, argc, argv);
+      if (!games)
+        return std::unexpected(games.error());
+      options.simulate = games.value();
+    } else if (arg == "--replay") {
+      auto journal = value(i, argc, argv);
+      if (!journal)
+        return std::unexpected(journal.error());
+      options.replay = journal.value();
+    } else if (arg == "--speed") {
+      auto speed = numberValue(i, argc, argv);
+      if (!speed || speed.value() == 0)
+        return std::unexpected(ErrorInvalidArgument(arg).error());
+      options.speed = speed.value();
+    } else if (arg == "--agent") {
+      auto agent = agentValue(i, argc, argv);
+      if (!agent)
+        return std::unexpected(agent.error());
+      options.agent = agent.value();
+    } else if (arg == "--mode") {
+      auto mode = modeValue(i, argc, argv);
+      if (!mode)
+        return std::unexpected(mode.error());
+      options.mode = mode.value();
+    } else if (arg == "--threads") {
+      auto threads = numberValue(i, argc, argv);
+      if (!threads || threads.value() == 0)
+        return std::unexpected(ErrorInvalidArgument(arg).error());
+      options.threads = threads.value();
+    } else if (arg == "--max-nodes") {
+      auto nodes = numberValue(i, argc, argv);
+      if (!nodes)
+        return std::unexpected(nodes.error());
+      options.maxNodes = nodes.value();
+    } else if (arg == "--output") {
+      auto output = value(i, argc, argv);
+      if (!output)
+        return std::unexpected(output.error());
+      options.output = output.value();
+    } else {
+      return std::unexpected(ErrorInvalidArgument(arg).error());
+    }
+  }
+
+  return options;
+}
+
+std::string Cli::usage() {
+  return "Usage: solitairecpp [options]\n"
+         "  --deal <number>          play the given deal, same number same "
+         "cards\n"
+         "  --analysis               show the chance to win the position, "
+         "keeps\n"
+         "                           the cores busy after every move\n"
+         "  -h, --help               show this message\n"
+         "\n"
+         "Headless modes:\n"
+         "  --solve-range <from> <to>\n"
+         "                           solve every deal in the range and append "
+         "the\n"
+         "                           results to --output, rerun to resume\n"
+         "  --build-deal-db <results>\n"
+         "                           turn the solved deals of a --solve-range "
+         "file\n"
+         "                           into the deal database new games draw "
+         "from\n"
+         "  --simulate <n>           play deals 0 to n-1 with --agent and "
+         "print the\n"
+         "                           win rate, move counts and game times\n"
+         "  --replay <journal>       play a game journal back, the last game "
+         "is in\n"
+         "                           last-game.journal in the data directory\n"
+         "\n"
+         "Headless settings:\n"
+         "  --mode <easy|hard>       game mode, easy by default\n"
+         "  --agent <random|greedy|solver>\n"
+         "                           who plays --simulate, greedy by default\n"
+         "  --threads <n>            worker threads, all cores by default\n"
+         "  --max-nodes <n>          give up on a deal after n positions\n"
+         "  --output <file>          file to write, solve-range.csv or the "
+         "deal\n"
+         "                           database in the data directory by "
+         "default\n"
+         "  --speed <n>              replay on the board at n moves a second "
+         "instead\n"
+         "                           of headless\n";
+}
+
+std::expected<std::string, Error> Cli::value(int &i, int argc, char **argv) {
+  if (i + 1 >= argc)
+    return std::unexpected(ErrorInvalidArgument(argv[i]).error());
+  return argv[++i];
+}
+
+std::expected<std::uint64_t, Error> Cli::numberValue(int &i, int argc,
+                                                     char **argv) {
+  auto arg = value(i, argc, argv);
+  if (!arg)
+    return std::unexpected(arg.error());
+  return parseNumber(arg.value());
+}
+
+std::expected<Difficulty, Error> Cli::modeValue(int &i, int argc,
+                                                char **argv) {
+  auto arg = value(i, argc, argv);
+  if (!arg)
+    return std::unexpected(arg.error());
+  if (arg.value() == "easy")
+    return Difficulty::Easy;
+  if (arg.value() == "hard")
+    return Difficulty::Hard;
+  return std::unexpected(ErrorInvalidArgument(arg.value()).error());
+}
+
+std::expected<Simulator::Agent, Error> Cli::agentValue(int &i, int argc,
+                                                      char **argv) {
+  auto arg = value(i, argc, argv);
+  if (!arg)
+    return std::unexpected(arg.error());
+  auto agent = Simulator::parseAgent(arg.value());
+  if (!agent)
+    return std::unexpected(ErrorInvalidArgument(arg.value()).error());
+  return agent.value();
+}
+
+std::expected<std::uint64_t, Error> Cli::parseNumber(const std::string &arg) {
+  std::uint64_t number{};
+  auto [end, error] =
+      std::from_chars(arg.data(), arg.data() + arg.size(), number);
+  if (error != std::errc() || end != arg.data() + arg.size())
+    return std::unexpected(ErrorInvalidArgument(arg).error());
+  return number;
+}
+
+} // namespace solitairecpp
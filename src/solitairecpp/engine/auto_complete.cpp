@@ -0,0 +1,54 @@
+#include <solitairecpp/auto_complete.hpp>
+
+namespace solitairecpp {
+
+bool AutoComplete::decided(const GameState &state) {
+  for (size_t row{}; row < Piles::tableauSize; row++) {
+    const auto &cards = state.tableauRow(row);
+    if (!cards.empty() && cards.at(0).faceDown())
+      return false; // face down cards are always at the bottom
+  }
+  return true;
+}
+
+std::optional<Move> AutoComplete::next(const GameState &state) {
+  // only the tops can go to the foundations, no need to generate every move
+  std::optional<Move> any;
+  for (PileId from{}; from <= Piles::waste; from++) {
+    if (from == Piles::stock || state.pileSize(from) == 0)
+      continue;
+    const auto top = state.pileCard(from, state.pileSize(from) - 1);
+    for (size_t i{}; i < Piles::foundationsSize; i++) {
+      if (!state.isSetLegal(i, top))
+        continue;
+      const Move move{.from = from, .to = Piles::foundation(i), .count = 1};
+      if (state.isSafeFoundationMove(move))
+        return move;
+      if (!any)
+        any = move;
+    }
+  }
+
+  if (!decided(state))
+    return std::nullopt;
+  if (any)
+    return any;
+  if (state.isLegal(Move::draw()) && !state.won())
+    return Move::draw();
+  return std::nullopt;
+}
+
+std::vector<Move> AutoComplete::run(Session &session) {
+  std::vector<Move> applied;
+  size_t idleDraws{};
+  for (auto move = next(session.state()); move;
+       move = next(session.state())) {
+    idleDraws = move->isDraw() ? idleDraws + 1 : 0;
+    if (idleDraws > maxIdleDraws_ || !session.apply(move.value()))
+      break;
+    applied.push_back(move.value());
+  }
+  return applied;
+}
+
+} // namespace solitairecpp
@@ -0,0 +1,82 @@
+#include <filesystem>
+#include <solitairecpp/autosave.hpp>
+#include <solitairecpp/snapshot.hpp>
+#include <utility>
+
+namespace solitairecpp {
+
+Autosave::Autosave(std::string path)
+    : path_{std::move(path)},
+      writer_{[this](std::stop_token stop) { run(stop); }} {}
+
+// the stop wakes the writer through it's stop_token
+Autosave::~Autosave() { writer_.request_stop(); }
+
+void Autosave::save(const Session &session,
+                    const Snapshot::Progress &progress) {
+  {
+    std::lock_guard lock(mutex_);
+    Snapshot::encode(session, progress, front_);
+    pending_ = Pending::Store;
+    saves_++;
+  }
+  wake_.notify_one();
+}
+
+void Autosave::discard() {
+  {
+    std::lock_guard lock(mutex_);
+    pending_ = Pending::Remove;
+  }
+  wake_.notify_one();
+}
+
+void Autosave::flush() {
+  std::unique_lock lock(mutex_);
+  idle_.wait(lock, [&] { return pending_ == Pending::None && !busy_; });
+}
+
+std::uint64_t Autosave::saves() const {
+  std::lock_guard lock(mutex_);
+  return saves_;
+}
+
+std::uint64_t Autosave::writes() const {
+  std::lock_guard lock(mutex_);
+  return writes_;
+}
+
+// A stop still stores what's pending, that's the save of the last move
+void Autosave::run(std::stop_token stop) {
+  std::unique_lock lock(mutex_);
+  while (true) {
+    wake_.wait(lock, stop, [&] { return pending_ != Pending::None; });
+    if (pending_ == Pending::None) {
+      if (stop.stop_requested())
+        return;
+      continue;
+    }
+
+    const auto pending = std::exchange(pending_, Pending::None);
+    if (pending == Pending::Store)
+      std::swap(front_, back_);
+    busy_ = true;
+    lock.unlock();
+
+    // a failed autosave only costs the save, the game goes on
+    if (pending == Pending::Store) {
+      (void)Snapshot::store(path_, back_);
+    } else {
+      std::error_code error;
+      std::filesystem::remove(path_, error);
+    }
+
+    lock.lock();
+    busy_ = false;
+    if (pending == Pending::Store)
+      writes_++;
+    idle_.notify_all();
+  }
+}
+
+} // namespace solitairecpp
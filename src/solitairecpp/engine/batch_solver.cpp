@@ -0,0 +1,248 @@
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <optional>
+#include <solitairecpp/batch_solver.hpp>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace solitairecpp {
+
+namespace {
+
+constexpr std::string_view header = "deal,status,moves,nodes,microseconds";
+constexpr std::uint64_t maxRange = std::uint64_t{1} << 36;
+
+std::string_view statusName(Solver::Status status) {
+  switch (status) {
+  case Solver::Status::Solved:
+    return "solved";
+  case Solver::Status::Unsolvable:
+    return "unsolvable";
+  case Solver::Status::Unknown:
+    return "unknown";
+  }
+  return "";
+}
+
+// first line of the file, resuming with another mode would mix up results
+std::string modeLine(Difficulty mode) {
+  return mode == Difficulty::Easy ? "# mode easy" : "# mode hard";
+}
+
+std::optional<Solver::Status> parseStatus(std::string_view name) {
+  for (auto status : {Solver::Status::Solved, Solver::Status::Unsolvable,
+                      Solver::Status::Unknown})
+    if (statusName(status) == name)
+      return status;
+  return std::nullopt;
+}
+
+// deal,status,moves,nodes,microseconds
+std::optional<BatchSolver::Record> parseLine(std::string_view line) {
+  BatchSolver::Record record;
+  std::uint64_t moves{};
+  const auto *in = line.data();
+  const auto *end = line.data() + line.size();
+  const auto number = [&](std::uint64_t &value) {
+    auto [next, error] = std::from_chars(in, end, value);
+    in = next;
+    return error == std::errc();
+  };
+  const auto comma = [&] { return in != end && *in++ == ','; };
+
+  if (!number(record.deal) || !comma())
+    return std::nullopt;
+  const auto *statusEnd = std::find(in, end, ',');
+  const auto status = parseStatus(std::string_view(in, statusEnd));
+  in = statusEnd;
+  if (!status || !comma() || !number(moves) || !comma() ||
+      !number(record.nodes))
+    return std::nullopt;
+  record.status = status.value();
+  return record;
+}
+
+} // namespace
+
+BatchSolver::BatchSolver(const Options &options) : options_{options} {}
+
+std::expected<BatchSolver::Summary, Error>
+BatchSolver::run(const Progress &progress) {
+  const auto &path = options_.path;
+  if (options_.from > options_.to || options_.to - options_.from >= maxRange)
+    return std::unexpected(ErrorResultsFile(path, "bad deal range").error());
+
+  const std::uint64_t total = options_.to - options_.from + 1;
+  std::vector<bool> done(total);
+  Summary summary;
+
+  // Resume: mark the deals in the file as done and cut off a line that got
+  // only half written
+  std::error_code error;
+  std::uint64_t complete{}; // bytes up to the end of the last full line
+  if (std::filesystem::file_size(path, error) > 0 && !error) {
+    std::ifstream in(path, std::ios::binary);
+    std::string line;
+    size_t lineNumber{};
+    while (std::getline(in, line)) {
+      if (in.eof())
+        break; // no newline, a partial line
+      complete = static_cast<std::uint64_t>(in.tellg());
+
+      lineNumber++;
+      if (lineNumber == 1 && line != modeLine(options_.mode))
+        return std::unexpected(
+            ErrorResultsFile(path, "written for another mode").error());
+      if (lineNumber <= 2)
+        continue;
+
+      std::uint64_t deal{};
+      const auto end = line.data() + line.size();
+      if (std::from_chars(line.data(), end, deal).ec != std::errc())
+        return std::unexpected(
+            ErrorResultsFile(path, std::format("bad line {}", lineNumber))
+                .error());
+      if (deal >= options_.from && deal <= options_.to &&
+          !done[deal - options_.from]) {
+        done[deal - options_.from] = true;
+        summary.skipped++;
+      }
+    }
+    // without both header lines the file gets started over
+    if (lineNumber < 2)
+      complete = 0;
+    std::filesystem::resize_file(path, complete, error);
+    if (error)
+      return std::unexpected(ErrorResultsFile(path, error.message()).error());
+  }
+
+  std::ofstream out(path, std::ios::binary | std::ios::app);
+  if (!out)
+    return std::unexpected(ErrorResultsFile(path, "can't open").error());
+  if (complete == 0)
+    out << modeLine(options_.mode) << '\n' << header << '\n';
+
+  std::mutex outMutex;
+  std::atomic<std::uint64_t> next{};
+  std::atomic<std::uint64_t> finished{summary.skipped};
+  std::atomic<std::uint64_t> solved{}, unsolvable{}, unknown{};
+  const size_t threadCount = std::max<size_t>(1, options_.threads);
+  std::atomic<size_t> running{threadCount};
+  std::atomic<bool> failed{};
+
+  const auto work = [&] {
+    Solver solver(options_.limits);
+    std::string buffer;
+    size_t buffered{};
+    const auto flush = [&] {
+      std::lock_guard lock(outMutex);
+      out << buffer;
+      out.flush();
+      if (!out)
+        failed = true;
+      buffer.clear();
+      buffered = 0;
+    };
+
+    for (std::uint64_t i = next++; i < total && !failed; i = next++) {
+      if (done[i])
+        continue;
+
+      const auto deal = options_.from + i;
+      const auto result = solver.solve(GameState(options_.mode, deal));
+      const auto microseconds =
+          std::chrono::duration_cast<std::chrono::microseconds>(
+              result.elapsed);
+      buffer += std::format("{},{},{},{},{}\n", deal,
+                            statusName(result.status), result.moves.size(),
+                            result.nodes, microseconds.count());
+      switch (result.status) {
+      case Solver::Status::Solved:
+        solved++;
+        break;
+      case Solver::Status::Unsolvable:
+        unsolvable++;
+        break;
+      case Solver::Status::Unknown:
+        unknown++;
+        break;
+      }
+      finished++;
+      if (++buffered == batchSize_)
+        flush();
+    }
+    flush();
+    running--;
+  };
+
+  {
+    std::vector<std::jthread> threads;
+    for (size_t i{}; i < threadCount; i++)
+      threads.emplace_back(work);
+
+    auto lastReport = std::chrono::steady_clock::now();
+    while (running > 0) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(50));
+      if (progress &&
+          std::chrono::steady_clock::now() - lastReport >=
+              std::chrono::seconds(1)) {
+        progress(finished, total);
+        lastReport = std::chrono::steady_clock::now();
+      }
+    }
+  }
+  if (progress)
+    progress(finished, total);
+
+  if (failed)
+    return std::unexpected(ErrorResultsFile(path, "write failed").error());
+  summary.solved = solved;
+  summary.unsolvable = unsolvable;
+  summary.unknown = unknown;
+  return summary;
+}
+
+std::expected<BatchSolver::Results, Error>
+BatchSolver::read(const std::string &path) {
+  std::ifstream in(path, std::ios::binary);
+  if (!in)
+    return std::unexpected(ErrorResultsFile(path, "can't open").error());
+
+  Results results;
+  std::string line;
+  size_t lineNumber{};
+  while (std::getline(in, line)) {
+    if (in.eof())
+      break; // no newline, a partial line
+
+    lineNumber++;
+    if (lineNumber == 1) {
+      if (line == modeLine(Difficulty::Easy))
+        results.mode = Difficulty::Easy;
+      else if (line == modeLine(Difficulty::Hard))
+        results.mode = Difficulty::Hard;
+      else
+        return std::unexpected(
+            ErrorResultsFile(path, "no mode line").error());
+      continue;
+    }
+    if (lineNumber == 2)
+      continue;
+
+    auto record = parseLine(line);
+    if (!record)
+      return std::unexpected(
+          ErrorResultsFile(path, std::format("bad line {}", lineNumber))
+              .error());
+    results.records.push_back(record.value());
+  }
+  return results;
+}
+
+} // namespace solitairecpp
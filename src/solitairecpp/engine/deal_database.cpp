@@ -0,0 +1,211 @@
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <solitairecpp/deal_database.hpp>
+#include <solitairecpp/random.hpp>
+#include <string_view>
+#include <utility>
+
+namespace solitairecpp {
+
+namespace {
+
+constexpr std::string_view magic = "SCDB";
+
+void putU64(std::string &out, std::uint64_t value) {
+  for (int i{}; i < 8; i++)
+    out += static_cast<char>(value >> (8 * i));
+}
+
+// callers check the bounds
+std::uint64_t getU64(const std::byte *in) {
+  std::uint64_t value{};
+  for (int i{}; i < 8; i++)
+    value |= std::to_integer<std::uint64_t>(in[i]) << (8 * i);
+  return value;
+}
+
+// LEB128, 7 bits per byte with the high bit set on all but the last
+void putVarint(std::string &out, std::uint64_t value) {
+  while (value >= 0x80) {
+    out += static_cast<char>(value | 0x80);
+    value >>= 7;
+  }
+  out += static_cast<char>(value);
+}
+
+// Stops at end on a truncated file instead of reading past it
+std::uint64_t getVarint(const std::byte *&in, const std::byte *end) {
+  std::uint64_t value{};
+  for (int shift{}; in != end && shift < 64; shift += 7) {
+    const auto byte = std::to_integer<std::uint64_t>(*in++);
+    value |= (byte & 0x7F) << shift;
+    if ((byte & 0x80) == 0)
+      break;
+  }
+  return value;
+}
+
+} // namespace
+
+DealDatabase::Rating DealDatabase::rate(std::uint64_t nodes) {
+  if (nodes < 1'000)
+    return Rating::Quick;
+  if (nodes < 100'000)
+    return Rating::Medium;
+  return Rating::Long;
+}
+
+std::expected<void, Error> DealDatabase::write(const std::string &path,
+                                               Difficulty mode,
+                                               Buckets buckets) {
+  std::string header;
+  header += magic;
+  header += static_cast<char>(version_);
+  header += static_cast<char>(mode);
+  header += static_cast<char>(checkpointStride & 0xFF);
+  header += static_cast<char>(checkpointStride >> 8);
+
+  std::string body;
+  for (auto &deals : buckets) {
+    std::ranges::sort(deals);
+    const auto [first, last] = std::ranges::unique(deals);
+    deals.erase(first, last);
+
+    const size_t checkpoints =
+        (deals.size() + checkpointStride - 1) / checkpointStride;
+    std::string deltas;
+    std::string index;
+    for (size_t i{}; i < deals.size(); i++) {
+      if (i % checkpointStride == 0) {
+        putU64(index, deals[i]);
+        putU64(index, checkpoints * checkpointSize_ + deltas.size());
+      } else {
+        putVarint(deltas, deals[i] - deals[i - 1]);
+      }
+    }
+
+    putU64(header, deals.size());
+    putU64(header, headerSize_ + body.size());
+    putU64(header, index.size() + deltas.size());
+    body += index;
+    body += deltas;
+  }
+
+  // a half written database must never replace a good one
+  const std::filesystem::path target(path);
+  std::error_code error;
+  if (target.has_parent_path())
+    std::filesystem::create_directories(target.parent_path(), error);
+  const std::string temporary = path + ".tmp";
+  {
+    std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+    out << header << body;
+    out.flush();
+    if (!out)
+      return std::unexpected(ErrorFile(temporary, "write failed").error());
+  }
+  std::filesystem::rename(temporary, target, error);
+  if (error)
+    return std::unexpected(ErrorFile(path, error.message()).error());
+  return std::expected<void, Error>();
+}
+
+std::expected<DealDatabase, Error>
+DealDatabase::open(const std::string &path) {
+  auto file = MappedFile::open(path);
+  if (!file)
+    return std::unexpected(file.error());
+
+  const auto bytes = file->bytes();
+  const auto bad = [&](const char *reason) {
+    return std::unexpected(ErrorFile(path, reason).error());
+  };
+  if (bytes.size() < headerSize_ ||
+      std::memcmp(bytes.data(), magic.data(), magic.size()) != 0)
+    return bad("not a deal database");
+  if (std::to_integer<std::uint8_t>(bytes[4]) != version_)
+    return bad("unsupported deal database version");
+  const auto mode = std::to_integer<std::uint8_t>(bytes[5]);
+  if (mode > static_cast<std::uint8_t>(Difficulty::Hard))
+    return bad("unknown mode");
+  const auto stride = std::to_integer<size_t>(bytes[6]) |
+                      std::to_integer<size_t>(bytes[7]) << 8;
+  if (stride != checkpointStride)
+    return bad("unsupported checkpoint stride");
+
+  std::array<Bucket, ratingCount> buckets;
+  for (size_t i{}; i < ratingCount; i++) {
+    const auto *entry = bytes.data() + 8 + i * 24;
+    const auto count = getU64(entry);
+    const auto offset = getU64(entry + 8);
+    const auto size = getU64(entry + 16);
+    const auto checkpoints =
+        (count + checkpointStride - 1) / checkpointStride;
+    if (offset > bytes.size() || size > bytes.size() - offset ||
+        checkpoints > size / checkpointSize_)
+      return bad("truncated");
+
+    buckets[i] = {.count = count,
+                  .checkpoints = bytes.data() + offset,
+                  .deltas = bytes.data() + offset +
+                            checkpoints * checkpointSize_,
+                  .end = bytes.data() + offset + size};
+  }
+  return DealDatabase(std::move(file.value()), static_cast<Difficulty>(mode),
+                      buckets);
+}
+
+DealDatabase::DealDatabase(MappedFile file, Difficulty mode,
+                           std::array<Bucket, ratingCount> buckets)
+    : file_{std::move(file)}, mode_{mode}, buckets_{buckets} {}
+
+Difficulty DealDatabase::mode() const { return mode_; }
+
+size_t DealDatabase::size() const {
+  size_t total{};
+  for (const auto &bucket : buckets_)
+    total += bucket.count;
+  return total;
+}
+
+size_t DealDatabase::size(Rating rating) const {
+  return buckets_[static_cast<size_t>(rating)].count;
+}
+
+std::uint64_t DealDatabase::at(Rating rating, size_t index) const {
+  const auto &bucket = buckets_[static_cast<size_t>(rating)];
+  const auto *checkpoint =
+      bucket.checkpoints + index / checkpointStride * checkpointSize_;
+  std::uint64_t deal = getU64(checkpoint);
+  const auto *in = bucket.checkpoints + getU64(checkpoint + 8);
+  if (in < bucket.deltas || in > bucket.end)
+    return deal; // corrupt offset, the checkpoint itself is still a deal
+
+  for (size_t i = index % checkpointStride; i > 0; i--)
+    deal += getVarint(in, bucket.end);
+  return deal;
+}
+
+std::uint64_t DealDatabase::draw(std::uint64_t random) const {
+  if (size() == 0)
+    return 0;
+  SplitMix64 generator(random);
+  auto index = generator.below(size());
+  for (size_t i{}; i < ratingCount; i++) {
+    if (index < buckets_[i].count)
+      return at(static_cast<Rating>(i), index);
+    index -= buckets_[i].count;
+  }
+  std::unreachable();
+}
+
+std::uint64_t DealDatabase::draw(Rating rating, std::uint64_t random) const {
+  if (size(rating) == 0)
+    return 0;
+  SplitMix64 generator(random);
+  return at(rating, generator.below(size(rating)));
+}
+
+} // namespace solitairecpp
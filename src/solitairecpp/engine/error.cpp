@@ -0,0 +1,23 @@
+#include <solitairecpp/card_code.hpp>
+#include <solitairecpp/engine.hpp>
+#include <solitairecpp/error.hpp>
+#include <solitairecpp/session.hpp>
+#include <utility>
+
+namespace solitairecpp {
+
+Error toError(ErrorCode code) {
+  switch (code) {
+  case ErrorCode::IllegalMove:
+    return ErrorIllegalMove().error();
+  case ErrorCode::InvalidCardIndex:
+    return ErrorInvalidCardIndex().error();
+  case ErrorCode::NothingToUndo:
+    return ErrorNothingToUndo().error();
+  case ErrorCode::NothingToRedo:
+    return ErrorNothingToRedo().error();
+  }
+  std::unreachable();
+}
+
+} // namespace solitairecpp
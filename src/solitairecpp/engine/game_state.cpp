@@ -0,0 +1,436 @@
+#include <algorithm>
+#include <solitairecpp/engine.hpp>
+#include <utility>
+
+namespace solitairecpp {
+
+namespace {
+
+// A random key for every card on every spot it can be at, one for every card
+// being face down and one for the reshuffle count. The hash of a position is
+// the xor of the keys that apply to it, so a move only touches the keys of the
+// cards it moved.
+constexpr size_t maxPileSize = GameState::reserveStackStartCards;
+
+constexpr auto locationKeys = [] {
+  std::array<std::array<std::array<std::uint64_t, maxPileSize>, Piles::count>,
+             GameState::deckSize>
+      keys{};
+  SplitMix64 gen{0x5A0B1157};
+  for (auto &card : keys)
+    for (auto &pile : card)
+      for (auto &key : pile)
+        key = gen.next();
+  return keys;
+}();
+
+constexpr std::uint64_t faceDownKey(PackedCard card) {
+  return SplitMix64::mix(0xFACEDULL << 8 | card.index());
+}
+
+constexpr std::uint64_t locationKey(PackedCard card,
+                                    const GameState::Location &location) {
+  return locationKeys[card.index()][location.pile][location.depth];
+}
+
+} // namespace
+
+bool CardCode::operator==(const CardCode &rhs) const {
+  return value == rhs.value && type == rhs.type;
+}
+
+GameState::GameState(Difficulty mode, std::uint64_t dealNumber)
+    : mode_{mode}, dealNumber_{dealNumber} {
+  const auto deck = buildDeck(dealNumber);
+  size_t dealt{};
+  for (size_t row{}; row < tableau_.size(); row++) {
+    for (size_t i{}; i <= row; i++) {
+      // The last card of every row is visible
+      tableau_[row].push(PackedCard(deck[dealt++], i != row));
+    }
+  }
+
+  for (; dealt < deck.size(); dealt++)
+    stock_.push(PackedCard(deck[dealt]));
+
+  reindex();
+}
+
+void GameState::reindex() {
+  for (PileId pile{}; pile < Piles::count; pile++)
+    relocate(pile);
+
+  // relocate xored in the keys of the old index as well, start over
+  hash_ = 0;
+  for (PileId pile{}; pile < Piles::count; pile++) {
+    for (size_t depth{}; depth < pileSize(pile); depth++) {
+      const auto card = pileCard(pile, depth);
+      hash_ ^= locationKey(card, locations_[card.index()]);
+      if (card.faceDown())
+        hash_ ^= faceDownKey(card);
+    }
+  }
+}
+
+GameState::Deck GameState::buildDeck(std::uint64_t dealNumber) {
+  Deck deck;
+  for (size_t i{}; i < deck.size(); i++)
+    deck[i] = PackedCard::fromIndex(i).code();
+
+  SplitMix64 gen{dealNumber};
+  for (size_t i{deck.size()}; i > 1; i--)
+    std::swap(deck[i - 1], deck[gen.below(i)]);
+
+  return deck;
+}
+
+std::optional<GameState>
+GameState::restore(Difficulty mode, std::uint64_t dealNumber, size_t recycles,
+                   const std::array<std::uint8_t, Piles::count> &sizes,
+                   std::span<const PackedCard, deckSize> cards) {
+  GameState state;
+  state.mode_ = mode;
+  state.dealNumber_ = dealNumber;
+  state.recycles_ = static_cast<std::uint16_t>(recycles);
+
+  std::array<bool, deckSize> seen{};
+  size_t next{};
+  const auto fill = [&](auto &pile, size_t size) {
+    if (size > pile.capacity() || size > deckSize - next)
+      return false;
+    for (size_t i{}; i < size; i++) {
+      const auto card = cards[next++];
+      if (card.index() >= deckSize || seen[card.index()])
+        return false;
+      seen[card.index()] = true;
+      pile.push(card);
+    }
+    return true;
+  };
+
+  bool valid = recycles <= UINT16_MAX;
+  for (size_t row{}; row < Piles::tableauSize && valid; row++)
+    valid = fill(state.tableau_[row], sizes[Piles::tableau(row)]);
+  valid = valid && fill(state.stock_, sizes[Piles::stock]) &&
+          fill(state.waste_, sizes[Piles::waste]);
+  for (size_t i{}; i < Piles::foundationsSize && valid; i++)
+    valid = fill(state.foundations_[i], sizes[Piles::foundation(i)]);
+  if (!valid || next != deckSize)
+    return std::nullopt;
+
+  state.reindex();
+  return state;
+}
+
+GameState GameState::sample(std::uint64_t seed) const {
+  GameState sampled = *this;
+  SplitMix64 gen{seed};
+  // Fisher-Yates over the spots, each spot stays face down or not
+  const auto shuffle = [&](std::span<PackedCard *> spots) {
+    for (size_t i{spots.size()}; i > 1; i--) {
+      auto &a = *spots[i - 1];
+      auto &b = *spots[gen.below(i)];
+      const auto aFaceDown = a.faceDown();
+      const auto bFaceDown = b.faceDown();
+      std::swap(a, b);
+      a = a.withFaceDown(aFaceDown);
+      b = b.withFaceDown(bFaceDown);
+    }
+  };
+
+  std::array<PackedCard *, deckSize> hidden;
+  size_t count{};
+  for (auto &row : sampled.tableau_)
+    for (auto &card : row)
+      if (card.faceDown())
+        hidden[count++] = &card;
+  // Nobody saw the order of the stock, it was dealt or reshuffled. Before
+  // the first recycle the cards in it weren't seen either, so they mix with
+  // the face down ones. After it they all came from the waste, only their
+  // order is unknown.
+  std::array<PackedCard *, deckSize> stock;
+  size_t stockCount{};
+  for (auto &card : sampled.stock_)
+    if (recycles_ == 0)
+      hidden[count++] = &card;
+    else
+      stock[stockCount++] = &card;
+  shuffle(std::span(hidden.data(), count));
+  shuffle(std::span(stock.data(), stockCount));
+
+  sampled.dealNumber_ = seed;
+  sampled.reindex();
+  return sampled;
+}
+
+Difficulty GameState::mode() const { return mode_; }
+
+std::uint64_t GameState::dealNumber() const { return dealNumber_; }
+
+size_t GameState::recycles() const { return recycles_; }
+
+const GameState::TableauRow &GameState::tableauRow(size_t row) const {
+  return tableau_[row];
+}
+
+const GameState::ReserveCards &GameState::stock() const { return stock_; }
+
+const GameState::ReserveCards &GameState::waste() const { return waste_; }
+
+const GameState::Foundation &GameState::foundation(size_t index) const {
+  return foundations_[index];
+}
+
+size_t GameState::pileSize(PileId pile) const {
+  if (Piles::isTableau(pile))
+    return tableau_[pile].size();
+  if (Piles::isFoundation(pile))
+    return foundations_[Piles::foundationIndex(pile)].size();
+  return pile == Piles::stock ? stock_.size() : waste_.size();
+}
+
+PackedCard GameState::pileCard(PileId pile, size_t depth) const {
+  if (Piles::isTableau(pile))
+    return tableau_[pile].at(depth);
+  if (Piles::isFoundation(pile))
+    return foundations_[Piles::foundationIndex(pile)].at(depth);
+  return pile == Piles::stock ? stock_.at(depth) : waste_.at(depth);
+}
+
+size_t GameState::viewableWasteSize() const {
+  switch (mode_) {
+  case Difficulty::Easy:
+    return std::min<size_t>(1, waste_.size());
+  case Difficulty::Hard:
+    return std::min(hardDifficultyViewableAmount, waste_.size());
+  }
+  std::unreachable();
+}
+
+GameState::Location GameState::locate(const CardCode &code) const {
+  return locate(PackedCard(code));
+}
+
+GameState::Location GameState::locate(PackedCard card) const {
+  return locations_[card.index()];
+}
+
+void GameState::relocate(PileId pile, size_t depth) {
+  for (; depth < pileSize(pile); depth++) {
+    const auto card = pileCard(pile, depth);
+    auto &location = locations_[card.index()];
+    hash_ ^= locationKey(card, location);
+    location = {.pile = pile, .depth = static_cast<std::uint8_t>(depth)};
+    hash_ ^= locationKey(card, location);
+  }
+}
+
+void GameState::flip(PackedCard &card) {
+  hash_ ^= faceDownKey(card);
+  card = card.withFaceDown(!card.faceDown());
+}
+
+std::uint64_t GameState::hash() const {
+  return hash_ ^ SplitMix64::mix(recycles_);
+}
+
+// Same rules as the old CardRow::isAppendLegal, just on bytes
+bool GameState::isAppendLegal(size_t row, const PackedCard *cards,
+                              size_t count) const {
+  if (row >= tableau_.size() || count == 0)
+    return false; // empty sequence should not get appended
+
+  const auto &cardRow = tableau_[row];
+  if (cardRow.size() + count > cardRow.capacity())
+    return false;
+
+  // only sequence starting with a king can get appened
+  if (cardRow.empty() && cards[0].value() != CardValue::King)
+    return false;
+
+  // the first one can't be the same color and needs to be one lower
+  if (!cardRow.empty() &&
+      (cardRow.back().color() == cards[0].color() ||
+       static_cast<int>(cardRow.back().value()) - 1 !=
+           static_cast<int>(cards[0].value())))
+    return false;
+
+  for (size_t i{1}; i < count; i++) {
+    if (static_cast<int>(cards[i].value()) !=
+            static_cast<int>(cards[i - 1].value()) - 1 ||
+        cards[i].color() == cards[i - 1].color())
+      return false;
+  }
+
+  return true;
+}
+
+bool GameState::isSetLegal(size_t foundation, PackedCard card) const {
+  if (foundation >= foundations_.size())
+    return false;
+
+  const auto &cards = foundations_[foundation];
+  if (cards.empty())
+    return card.value() == CardValue::Ace;
+
+  return static_cast<int>(card.value()) ==
+             static_cast<int>(cards.back().value()) + 1 &&
+         card.type() == cards.back().type();
+}
+
+bool GameState::isLegal(const Move &move) const {
+  if (move.isDraw())
+    return move.to == Piles::waste && (!stock_.empty() || !waste_.empty());
+
+  if (Piles::isTableau(move.from)) {
+    const auto &cardRow = tableau_[move.from];
+    if (move.count == 0 || move.count > cardRow.size())
+      return false;
+
+    const auto start = cardRow.size() - move.count;
+    if (cardRow.at(start).faceDown())
+      return false;
+
+    if (Piles::isTableau(move.to))
+      return move.to != move.from &&
+             isAppendLegal(move.to, cardRow.begin() + start, move.count);
+    if (Piles::isFoundation(move.to))
+      return move.count == 1 &&
+             isSetLegal(Piles::foundationIndex(move.to), cardRow.back());
+    return false;
+  }
+
+  if (move.from == Piles::waste) {
+    if (waste_.empty() || move.count != 1)
+      return false;
+
+    if (Piles::isTableau(move.to))
+      return isAppendLegal(move.to, waste_.end() - 1, 1);
+    if (Piles::isFoundation(move.to))
+      return isSetLegal(Piles::foundationIndex(move.to), waste_.back());
+  }
+
+  return false;
+}
+
+std::expected<void, ErrorCode> GameState::apply(Move &move) {
+  if (!isLegal(move))
+    return std::unexpected(ErrorCode::IllegalMove);
+
+  move.flags = 0;
+  if (move.isDraw()) {
+    if (stock_.empty()) {
+      recycle();
+      move.flags |= Move::recycledFlag;
+    }
+
+    const size_t amount = mode_ == Difficulty::Easy
+                              ? 1
+                              : std::min(hardDifficultyViewableAmount,
+                                         stock_.size());
+    for (size_t i{}; i < amount; i++)
+      waste_.push(stock_.pop());
+    relocate(Piles::waste, waste_.size() - amount);
+    move.count = static_cast<std::uint8_t>(amount);
+    return {};
+  }
+
+  PackedCard moved[maxTableauRowSize];
+  if (Piles::isTableau(move.from)) {
+    auto &cardRow = tableau_[move.from];
+    std::copy(cardRow.end() - move.count, cardRow.end(), moved);
+    cardRow.resize(cardRow.size() - move.count);
+
+    // Reveal the last card
+    if (!cardRow.empty() && cardRow.back().faceDown()) {
+      flip(cardRow.back());
+      move.flags |= Move::revealedFlag;
+    }
+  } else {
+    moved[0] = waste_.pop();
+  }
+
+  if (Piles::isTableau(move.to)) {
+    for (size_t i{}; i < move.count; i++)
+      tableau_[move.to].push(moved[i]);
+  } else {
+    foundations_[Piles::foundationIndex(move.to)].push(moved[0]);
+  }
+  relocate(move.to, pileSize(move.to) - move.count);
+
+  return {};
+}
+
+void GameState::undo(const Move &move) {
+  if (move.isDraw()) {
+    for (size_t i{}; i < move.count; i++)
+      stock_.push(waste_.pop());
+    relocate(Piles::stock, stock_.size() - move.count);
+    if (move.flags & Move::recycledFlag)
+      unrecycle();
+    return;
+  }
+
+  PackedCard moved[maxTableauRowSize];
+  if (Piles::isTableau(move.to)) {
+    auto &cardRow = tableau_[move.to];
+    std::copy(cardRow.end() - move.count, cardRow.end(), moved);
+    cardRow.resize(cardRow.size() - move.count);
+  } else {
+    moved[0] = foundations_[Piles::foundationIndex(move.to)].pop();
+  }
+
+  if (Piles::isTableau(move.from)) {
+    auto &cardRow = tableau_[move.from];
+    if (move.flags & Move::revealedFlag)
+      flip(cardRow.back());
+    for (size_t i{}; i < move.count; i++)
+      cardRow.push(moved[i]);
+  } else {
+    waste_.push(moved[0]);
+  }
+  relocate(move.from, pileSize(move.from) - move.count);
+}
+
+bool GameState::won() const {
+  return std::all_of(foundations_.begin(), foundations_.end(),
+                     [](const auto &cards) {
+                       return cards.size() == foundationSize;
+                     });
+}
+
+// Every reshuffle gets it's own stream derived from the deal number and the
+// amount of reshuffles before it. That makes it replayable, which undo needs.
+SplitMix64 GameState::recycleGenerator() const {
+  return SplitMix64(
+      SplitMix64::mix(dealNumber_ ^ SplitMix64::mix(recycles_ + 1)));
+}
+
+void GameState::recycle() {
+  while (!waste_.empty())
+    stock_.push(waste_.pop());
+
+  auto gen = recycleGenerator();
+  for (size_t i{stock_.size()}; i > 1; i--)
+    std::swap(stock_.at(i - 1), stock_.at(gen.below(i)));
+  relocate(Piles::stock);
+  recycles_++;
+}
+
+// Replays the swaps of recycle() backwards, which restores the waste exactly
+void GameState::unrecycle() {
+  recycles_--;
+
+  auto gen = recycleGenerator();
+  std::array<std::uint8_t, reserveStackStartCards> swaps{};
+  for (size_t i{stock_.size()}; i > 1; i--)
+    swaps[i - 1] = static_cast<std::uint8_t>(gen.below(i));
+  for (size_t i{2}; i <= stock_.size(); i++)
+    std::swap(stock_.at(i - 1), stock_.at(swaps[i - 1]));
+
+  while (!stock_.empty())
+    waste_.push(stock_.pop());
+  relocate(Piles::waste);
+}
+
+} // namespace solitairecpp
@@ -0,0 +1,98 @@
+#include <limits>
+#include <solitairecpp/hint_engine.hpp>
+#include <solitairecpp/solver.hpp>
+
+namespace solitairecpp {
+
+void HintEngine::touched(const Move &move) {
+  dirty_ |= static_cast<std::uint16_t>(1 << move.from | 1 << move.to);
+}
+
+void HintEngine::reset() { dirty_ = allPiles_; }
+
+std::optional<Move> HintEngine::best(const GameState &state) {
+  refresh(state);
+
+  // players can reshuffle as often as they like
+  constexpr auto noRecycleLimit = std::numeric_limits<size_t>::max();
+  std::optional<Move> best;
+  // a split that frees nothing isn't worth suggesting
+  auto bestRank = Solver::Rank::Unpromising;
+  for (const auto &source : sources_) {
+    for (size_t i{}; i < source.count; i++) {
+      const auto &move = source.moves[i];
+      if (Piles::isFoundation(move.to) && state.isSafeFoundationMove(move))
+        return move;
+      const auto rank = Solver::rank(state, move, false, noRecycleLimit);
+      if (rank < bestRank) {
+        best = move;
+        bestRank = rank;
+      }
+    }
+  }
+  return best;
+}
+
+void HintEngine::refresh(const GameState &state) {
+  if (dirty_ == 0)
+    return;
+
+  for (PileId from{}; from < sourceCount_; from++) {
+    auto &source = sources_[from];
+    if (isDirty(dirty_, from)) {
+      source.count = 0;
+    } else {
+      // only the moves into touched piles can have changed
+      std::uint8_t kept{};
+      for (size_t i{}; i < source.count; i++)
+        if (!isDirty(dirty_, source.moves[i].to))
+          source.moves[kept++] = source.moves[i];
+      source.count = kept;
+    }
+
+    const bool all = isDirty(dirty_, from);
+    if (from == Piles::stock) {
+      if (all || isDirty(dirty_, Piles::waste))
+        add(state, from, Piles::waste, source);
+      continue;
+    }
+    for (PileId to{}; to < Piles::count; to++) {
+      const bool target = Piles::isTableau(to) || Piles::isFoundation(to);
+      if (target && to != from && (all || isDirty(dirty_, to)))
+        add(state, from, to, source);
+    }
+  }
+  dirty_ = 0;
+}
+
+void HintEngine::add(const GameState &state, PileId from, PileId to,
+                     Source &source) {
+  const auto push = [&](Move move) {
+    if (state.isLegal(move))
+      source.moves[source.count++] = move;
+  };
+
+  if (from == Piles::stock)
+    return push(Move::draw());
+  if (from == Piles::waste)
+    return push({.from = from, .to = to, .count = 1});
+
+  const auto &row = state.tableauRow(from);
+  if (Piles::isFoundation(to))
+    return push({.from = from, .to = to, .count = 1});
+  for (size_t i = row.size(); i > 0 && !row.at(i - 1).faceDown(); i--) {
+    const Move move{.from = from,
+                    .to = to,
+                    .count = static_cast<std::uint8_t>(row.size() - i + 1)};
+    if (state.isLegal(move)) {
+      source.moves[source.count++] = move;
+      return; // the one card of the run that fits
+    }
+  }
+}
+
+bool HintEngine::isDirty(std::uint16_t dirty, PileId pile) {
+  return dirty & (1 << pile);
+}
+
+} // namespace solitairecpp
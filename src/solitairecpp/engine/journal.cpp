@@ -0,0 +1,204 @@
+#include <cstring>
+#include <filesystem>
+#include <solitairecpp/journal.hpp>
+#include <string_view>
+
+namespace solitairecpp {
+
+namespace {
+
+constexpr std::string_view magic = "SCRJ";
+constexpr std::uint8_t version = 1;
+
+constexpr std::uint16_t kindMask = 0x3;
+constexpr int fromShift = 2;
+constexpr int toShift = 6;
+constexpr int countShift = 10;
+constexpr std::uint16_t pileMask = 0xF;
+constexpr std::uint16_t countMask = 0x3F;
+
+} // namespace
+
+std::uint16_t Journal::pack(const Record &record) {
+  auto bits = static_cast<std::uint16_t>(record.kind);
+  if (record.kind == Kind::Apply) {
+    // a draw's count depends on what's left in the stock, apply works it out
+    const std::uint16_t count = record.move.isDraw() ? 0 : record.move.count;
+    bits |= (record.move.from & pileMask) << fromShift |
+            (record.move.to & pileMask) << toShift |
+            (count & countMask) << countShift;
+  }
+  return bits;
+}
+
+std::optional<Journal::Record> Journal::unpack(std::uint16_t bits) {
+  const auto kind = static_cast<Kind>(bits & kindMask);
+  if (kind > Kind::Redo)
+    return std::nullopt;
+  if (kind != Kind::Apply)
+    return bits >> fromShift == 0 ? std::optional(Record{.kind = kind})
+                                  : std::nullopt;
+
+  const Move move{
+      .from = static_cast<PileId>(bits >> fromShift & pileMask),
+      .to = static_cast<PileId>(bits >> toShift & pileMask),
+      .count = static_cast<std::uint8_t>(bits >> countShift & countMask)};
+  if (move.from >= Piles::count || move.to >= Piles::count)
+    return std::nullopt;
+  return Record{.kind = kind, .move = move};
+}
+
+std::expected<Journal, Error> Journal::open(const std::string &path) {
+  auto file = MappedFile::open(path);
+  if (!file)
+    return std::unexpected(file.error());
+
+  const auto bytes = file->bytes();
+  const auto bad = [&](const char *reason) {
+    return std::unexpected(ErrorFile(path, reason).error());
+  };
+  if (bytes.size() < headerSize ||
+      std::memcmp(bytes.data(), magic.data(), magic.size()) != 0)
+    return bad("not a journal");
+  if (std::to_integer<std::uint8_t>(bytes[4]) != version)
+    return bad("unsupported journal version");
+  const auto mode = std::to_integer<std::uint8_t>(bytes[5]);
+  if (mode > static_cast<std::uint8_t>(Difficulty::Hard))
+    return bad("unknown mode");
+
+  std::uint64_t dealNumber{};
+  for (int i{}; i < 8; i++)
+    dealNumber |= std::to_integer<std::uint64_t>(bytes[8 + i]) << (8 * i);
+  return Journal(std::move(file.value()), static_cast<Difficulty>(mode),
+                 dealNumber);
+}
+
+Journal::Journal(MappedFile file, Difficulty mode, std::uint64_t dealNumber)
+    : file_{std::move(file)}, mode_{mode}, dealNumber_{dealNumber} {}
+
+Difficulty Journal::mode() const { return mode_; }
+
+std::uint64_t Journal::dealNumber() const { return dealNumber_; }
+
+size_t Journal::size() const {
+  return (file_.bytes().size() - headerSize) / recordSize;
+}
+
+std::optional<Journal::Record> Journal::at(size_t index) const {
+  const auto *in = file_.bytes().data() + headerSize + index * recordSize;
+  return unpack(static_cast<std::uint16_t>(std::to_integer<unsigned>(in[0]) |
+                                           std::to_integer<unsigned>(in[1])
+                                               << 8));
+}
+
+std::expected<void, ErrorCode> Journal::replay(Session &session,
+                                               const Record &record) {
+  switch (record.kind) {
+  case Kind::Apply: {
+    auto move = record.move;
+    return session.apply(move);
+  }
+  case Kind::Undo: {
+    auto move = session.undo();
+    if (!move)
+      return std::unexpected(move.error());
+    return std::expected<void, ErrorCode>();
+  }
+  case Kind::Redo: {
+    auto move = session.redo();
+    if (!move)
+      return std::unexpected(move.error());
+    return std::expected<void, ErrorCode>();
+  }
+  }
+  return std::unexpected(ErrorCode::IllegalMove);
+}
+
+std::expected<JournalWriter, Error>
+JournalWriter::create(const std::string &path, Difficulty mode,
+                      std::uint64_t dealNumber) {
+  std::error_code error;
+  const auto directory = std::filesystem::path(path).parent_path();
+  if (!directory.empty())
+    std::filesystem::create_directories(directory, error);
+
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  if (!out)
+    return std::unexpected(ErrorFile(path, "can't open").error());
+
+  std::string header;
+  header += magic;
+  header += static_cast<char>(version);
+  header += static_cast<char>(mode);
+  header += std::string(2, '\0');
+  for (int i{}; i < 8; i++)
+    header += static_cast<char>(dealNumber >> (8 * i));
+  out << header;
+  out.flush();
+  if (!out)
+    return std::unexpected(ErrorFile(path, "write failed").error());
+  return JournalWriter(std::move(out), 0);
+}
+
+std::expected<JournalWriter, Error>
+JournalWriter::append(const std::string &path, Difficulty mode,
+                      std::uint64_t dealNumber, size_t records) {
+  {
+    auto journal = Journal::open(path);
+    if (!journal)
+      return std::unexpected(journal.error());
+    if (journal->mode() != mode || journal->dealNumber() != dealNumber)
+      return std::unexpected(ErrorFile(path, "of another game").error());
+    if (journal->size() < records)
+      return std::unexpected(
+          ErrorFile(path, "shorter than the snapshot").error());
+  }
+
+  std::error_code error;
+  std::filesystem::resize_file(
+      path, Journal::headerSize + records * Journal::recordSize, error);
+  if (error)
+    return std::unexpected(ErrorFile(path, error.message()).error());
+  std::ofstream out(path, std::ios::binary | std::ios::app);
+  if (!out)
+    return std::unexpected(ErrorFile(path, "can't open").error());
+  return JournalWriter(std::move(out), records);
+}
+
+// Every move of the log applied and the redoable ones undone again gives the
+// same position and history, the undo and redo churn before it is lost
+std::expected<JournalWriter, Error>
+JournalWriter::rebuild(const std::string &path, const Session &session) {
+  const auto &history = session.history();
+  if (session.moveCount() != history.undoSize())
+    return std::unexpected(
+        ErrorFile(path, "the undo log doesn't reach the deal").error());
+
+  auto writer =
+      create(path, session.state().mode(), session.state().dealNumber());
+  if (!writer)
+    return writer;
+  for (size_t i{}; i < history.undoSize() + history.redoSize(); i++)
+    writer->record({.kind = Journal::Kind::Apply, .move = history.at(i)});
+  for (size_t i{}; i < history.redoSize(); i++)
+    writer->record({.kind = Journal::Kind::Undo});
+  return writer;
+}
+
+JournalWriter::JournalWriter(std::ofstream out, size_t records)
+    : out_{std::move(out)}, records_{records} {}
+
+// A failed write only costs the journal, never the game
+void JournalWriter::record(const Journal::Record &record) {
+  const auto bits = Journal::pack(record);
+  const char bytes[] = {static_cast<char>(bits & 0xFF),
+                        static_cast<char>(bits >> 8)};
+  out_.write(bytes, sizeof(bytes));
+  out_.flush();
+  if (out_)
+    records_++;
+}
+
+size_t JournalWriter::size() const { return records_; }
+
+} // namespace solitairecpp
@@ -0,0 +1,64 @@
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <solitairecpp/mapped_file.hpp>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utility>
+
+namespace solitairecpp {
+
+std::expected<MappedFile, Error> MappedFile::open(const std::string &path) {
+  const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0)
+    return std::unexpected(ErrorFile(path, std::strerror(errno)).error());
+
+  struct stat info{};
+  if (::fstat(fd, &info) != 0) {
+    const auto reason = std::strerror(errno);
+    ::close(fd);
+    return std::unexpected(ErrorFile(path, reason).error());
+  }
+
+  const auto size = static_cast<size_t>(info.st_size);
+  if (size == 0) {
+    ::close(fd);
+    return MappedFile(nullptr, 0); // mmap refuses empty mappings
+  }
+
+  void *data = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd); // the mapping keeps the file alive
+  if (data == MAP_FAILED)
+    return std::unexpected(ErrorFile(path, std::strerror(errno)).error());
+  return MappedFile(static_cast<const std::byte *>(data), size);
+}
+
+MappedFile::MappedFile(const std::byte *data, size_t size)
+    : data_{data}, size_{size} {}
+
+MappedFile::MappedFile(MappedFile &&other) noexcept
+    : data_{std::exchange(other.data_, nullptr)},
+      size_{std::exchange(other.size_, 0)} {}
+
+MappedFile &MappedFile::operator=(MappedFile &&other) noexcept {
+  if (this != &other) {
+    unmap();
+    data_ = std::exchange(other.data_, nullptr);
+    size_ = std::exchange(other.size_, 0);
+  }
+  return *this;
+}
+
+MappedFile::~MappedFile() { unmap(); }
+
+void MappedFile::unmap() {
+  if (data_ != nullptr)
+    ::munmap(const_cast<std::byte *>(data_), size_);
+  data_ = nullptr;
+  size_ = 0;
+}
+
+std::span<const std::byte> MappedFile::bytes() const { return {data_, size_}; }
+
+} // namespace solitairecpp
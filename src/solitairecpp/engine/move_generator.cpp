@@ -0,0 +1,127 @@
+#include <solitairecpp/engine.hpp>
+
+namespace solitairecpp {
+
+size_t GameState::generateMoves(MoveList &moves) const {
+  Move *out = moves.data();
+  const auto emit = [&](PileId from, PileId to, size_t cards) {
+    *out++ = {
+        .from = from, .to = to, .count = static_cast<std::uint8_t>(cards)};
+  };
+
+  int firstEmptyFoundation = -1;
+  for (size_t i{}; i < foundations_.size() && firstEmptyFoundation < 0; i++)
+    if (foundations_[i].empty())
+      firstEmptyFoundation = static_cast<int>(i);
+
+  int firstEmptyRow = -1;
+  // everything from the first face up card on is a valid run, only valid
+  // runs ever get appended. Cached per row since every target looks at them.
+  std::array<std::uint8_t, Piles::tableauSize> runStart{};
+  std::array<int, Piles::tableauSize> runValue{};
+  for (size_t row{}; row < tableau_.size(); row++) {
+    const auto &cards = tableau_[row];
+    if (cards.empty() && firstEmptyRow < 0)
+      firstEmptyRow = static_cast<int>(row);
+
+    size_t start = cards.size();
+    while (start > 0 && !cards.at(start - 1).faceDown())
+      start--;
+    runStart[row] = static_cast<std::uint8_t>(start);
+    runValue[row] = start < cards.size()
+                        ? static_cast<int>(cards.at(start).value())
+                        : -1;
+  }
+
+  // the foundation holding the card right below, found through the index
+  const auto foundationFor = [&](PackedCard card) -> int {
+    if (card.value() == CardValue::Ace)
+      return firstEmptyFoundation;
+
+    const auto below =
+        locations_[card.index() - static_cast<size_t>(CardType::Count)];
+    if (!Piles::isFoundation(below.pile) ||
+        below.depth + 1u != foundations_[Piles::foundationIndex(below.pile)]
+                                .size())
+      return -1;
+    return static_cast<int>(Piles::foundationIndex(below.pile));
+  };
+
+  for (size_t row{}; row < tableau_.size(); row++) {
+    if (tableau_[row].empty())
+      continue;
+    const int foundation = foundationFor(tableau_[row].back());
+    if (foundation >= 0)
+      emit(Piles::tableau(row), Piles::foundation(foundation), 1);
+  }
+  if (!waste_.empty()) {
+    const int foundation = foundationFor(waste_.back());
+    if (foundation >= 0)
+      emit(Piles::waste, Piles::foundation(foundation), 1);
+  }
+
+  for (size_t to{}; to < tableau_.size(); to++) {
+    const auto &target = tableau_[to];
+    if (target.empty() && static_cast<int>(to) != firstEmptyRow)
+      continue;
+
+    // the only card that fits is a king on an empty row, otherwise the card
+    // one lower than the top of the other color
+    const int wanted =
+        static_cast<int>(target.empty() ? CardValue::King
+                                        : target.back().value()) -
+        (target.empty() ? 0 : 1);
+    if (wanted < 0)
+      continue;
+    const bool anyColor = target.empty();
+    const auto color = anyColor ? CardColor{} : target.back().color();
+    const auto fits = [&](PackedCard card) {
+      return static_cast<int>(card.value()) == wanted &&
+             (anyColor || card.color() != color);
+    };
+
+    for (size_t from{}; from < tableau_.size(); from++) {
+      // runs descend one by one, so the card with the wanted value sits at a
+      // known offset from the start of the run
+      const int offset = runValue[from] - wanted;
+      const auto &source = tableau_[from];
+      const size_t index = runStart[from] + offset;
+      if (from == to || offset < 0 || index >= source.size() ||
+          !fits(source.at(index)))
+        continue;
+      emit(Piles::tableau(from), Piles::tableau(to), source.size() - index);
+    }
+
+    if (!waste_.empty() && fits(waste_.back()))
+      emit(Piles::waste, Piles::tableau(to), 1);
+  }
+
+  if (!stock_.empty() || !waste_.empty())
+    *out++ = Move::draw();
+
+  return static_cast<size_t>(out - moves.data());
+}
+
+bool GameState::isSafeFoundationMove(const Move &move) const {
+  if (!Piles::isFoundation(move.to) || move.isDraw() || !isLegal(move))
+    return false;
+
+  const auto card = Piles::isTableau(move.from) ? tableau_[move.from].back()
+                                                : waste_.back();
+  const auto value = static_cast<size_t>(card.value());
+  if (value <= static_cast<size_t>(CardValue::Two))
+    return true;
+
+  // the cards that could go on top of it are one lower of the other color,
+  // it's safe once both of those are gone
+  constexpr auto typeCount = static_cast<size_t>(CardType::Count);
+  for (size_t type{}; type < typeCount; type++) {
+    const auto below = PackedCard::fromIndex((value - 1) * typeCount + type);
+    if (below.color() != card.color() &&
+        !Piles::isFoundation(locations_[below.index()].pile))
+      return false;
+  }
+  return true;
+}
+
+} // namespace solitairecpp
@@ -0,0 +1,47 @@
+#include <solitairecpp/move_log.hpp>
+
+namespace solitairecpp {
+
+MoveLog::MoveLog(size_t capacity) : buffer_(capacity == 0 ? 1 : capacity) {}
+
+void MoveLog::push(const Move &move) {
+  buffer_[slot(undoSize_)] = move;
+  redoSize_ = 0;
+  if (undoSize_ == buffer_.size())
+    begin_ = slot(1);
+  else
+    undoSize_++;
+}
+
+std::optional<Move> MoveLog::undo() {
+  if (undoSize_ == 0)
+    return std::nullopt;
+
+  undoSize_--;
+  redoSize_++;
+  return buffer_[slot(undoSize_)];
+}
+
+std::optional<Move> MoveLog::redo() {
+  if (redoSize_ == 0)
+    return std::nullopt;
+
+  const auto move = buffer_[slot(undoSize_)];
+  undoSize_++;
+  redoSize_--;
+  return move;
+}
+
+size_t MoveLog::undoSize() const { return undoSize_; }
+
+size_t MoveLog::redoSize() const { return redoSize_; }
+
+size_t MoveLog::capacity() const { return buffer_.size(); }
+
+const Move &MoveLog::at(size_t index) const { return buffer_[slot(index)]; }
+
+size_t MoveLog::slot(size_t offset) const {
+  return (begin_ + offset) % buffer_.size();
+}
+
+} // namespace solitairecpp
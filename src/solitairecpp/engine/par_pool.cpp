@@ -0,0 +1,177 @@
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <solitairecpp/mapped_file.hpp>
+#include <solitairecpp/par_pool.hpp>
+#include <string_view>
+#include <utility>
+
+namespace solitairecpp {
+
+namespace {
+
+constexpr std::string_view magic = "SCPR";
+constexpr std::uint8_t version = 1;
+
+// callers check the bounds
+std::uint64_t get(const std::byte *in, int bytes) {
+  std::uint64_t value{};
+  for (int i{}; i < bytes; i++)
+    value |= std::to_integer<std::uint64_t>(in[i]) << (8 * i);
+  return value;
+}
+
+void put(std::string &out, std::uint64_t value, int bytes) {
+  for (int i{}; i < bytes; i++)
+    out += static_cast<char>(value >> (8 * i));
+}
+
+} // namespace
+
+ParPool::ParPool(size_t threads, const ParSolver::Limits &limits,
+                 std::string path)
+    : limits_{limits}, path_{std::move(path)} {
+  load();
+  for (size_t i{}; i < std::max<size_t>(1, threads); i++)
+    threads_.emplace_back([this](std::stop_token stop) { run(stop); });
+}
+
+ParPool::~ParPool() {
+  for (auto &thread : threads_)
+    thread.request_stop();
+  wake_.notify_all();
+  threads_.clear(); // joins, before the members the threads use go away
+}
+
+void ParPool::request(Difficulty mode, std::uint64_t dealNumber) {
+  {
+    std::lock_guard lock(mutex_);
+    auto &known = cache_[static_cast<size_t>(mode)];
+    if (!known.try_emplace(dealNumber).second)
+      return;
+    queue_.push_back({.mode = mode, .dealNumber = dealNumber});
+  }
+  wake_.notify_one();
+}
+
+std::optional<ParPool::Par> ParPool::find(Difficulty mode,
+                                          std::uint64_t dealNumber) const {
+  std::lock_guard lock(mutex_);
+  const auto &known = cache_[static_cast<size_t>(mode)];
+  const auto par = known.find(dealNumber);
+  if (par == known.end())
+    return std::nullopt;
+  return par->second;
+}
+
+void ParPool::run(std::stop_token stop) {
+  ParSolver solver(limits_);
+  while (true) {
+    Job job;
+    {
+      std::unique_lock lock(mutex_);
+      if (!wake_.wait(lock, stop, [&] { return !queue_.empty(); }))
+        return; // stopped
+      job = queue_.front();
+      queue_.pop_front();
+    }
+
+    const auto result = solver.solve(GameState(job.mode, job.dealNumber), stop);
+    const Par par{.status = result.status,
+                  .moves = result.moves.size(),
+                  .weight = result.weight};
+    {
+      std::lock_guard lock(mutex_);
+      auto &known = cache_[static_cast<size_t>(job.mode)];
+      if (stop.stop_requested() && par.status == Solver::Status::Unknown) {
+        known.erase(job.dealNumber); // cut short, not a real answer
+        return;
+      }
+      known[job.dealNumber] = par;
+    }
+    if (par.status != Solver::Status::Unknown)
+      store(job, par);
+  }
+}
+
+// Before the threads start, a missing or unreadable file knows no pars and a
+// half written last record is left out
+void ParPool::load() {
+  if (path_.empty())
+    return;
+  auto file = MappedFile::open(path_);
+  if (!file)
+    return;
+  const auto bytes = file->bytes();
+  if (bytes.size() < headerSize ||
+      std::memcmp(bytes.data(), magic.data(), magic.size()) != 0 ||
+      std::to_integer<std::uint8_t>(bytes[4]) != version) {
+    readOnly_ = !bytes.empty();
+    return;
+  }
+
+  records_ = (bytes.size() - headerSize) / recordSize;
+  const auto *in = bytes.data() + headerSize;
+  for (std::uint64_t i{}; i < records_; i++, in += recordSize) {
+    const auto mode = get(in + 8, 1);
+    const auto status = static_cast<Solver::Status>(get(in + 9, 1));
+    if (mode > static_cast<std::uint8_t>(Difficulty::Hard) ||
+        (status != Solver::Status::Solved &&
+         status != Solver::Status::Unsolvable))
+      continue; // garbage
+    cache_[mode][get(in, 8)] =
+        Par{.status = status,
+            .moves = static_cast<size_t>(get(in + 10, 2)),
+            .weight = static_cast<double>(get(in + 12, 4)) / 1000};
+  }
+}
+
+void ParPool::store(const Job &job, const Par &par) {
+  std::lock_guard lock(fileMutex_);
+  if (path_.empty() || readOnly_)
+    return;
+
+  // starts the file when there is none and cuts off a half written last
+  // record, appending after it would shift the records that follow
+  if (!out_.is_open()) {
+    const auto path = std::filesystem::path(path_);
+    std::error_code error;
+    if (path.has_parent_path())
+      std::filesystem::create_directories(path.parent_path(), error);
+    bool started{};
+    if (records_ == 0) {
+      std::string header(magic);
+      put(header, version, 1);
+      put(header, 0, 3);
+      std::ofstream file(path_, std::ios::binary | std::ios::trunc);
+      file << header;
+      started = static_cast<bool>(file);
+    } else {
+      std::filesystem::resize_file(path, headerSize + records_ * recordSize,
+                                   error);
+      started = !error;
+    }
+    if (started)
+      out_.open(path_, std::ios::binary | std::ios::app);
+    if (!started || !out_) {
+      readOnly_ = true;
+      return;
+    }
+  }
+
+  std::string record;
+  put(record, job.dealNumber, 8);
+  put(record, static_cast<std::uint8_t>(job.mode), 1);
+  put(record, static_cast<std::uint8_t>(par.status), 1);
+  put(record, std::min<size_t>(par.moves, UINT16_MAX), 2);
+  put(record, static_cast<std::uint64_t>(std::lround(par.weight * 1000)), 4);
+  out_.write(record.data(), static_cast<std::streamsize>(record.size()));
+  out_.flush();
+  if (!out_)
+    readOnly_ = true; // the records after it would be off
+  else
+    records_++;
+}
+
+} // namespace solitairecpp
@@ -0,0 +1,191 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <solitairecpp/par_solver.hpp>
+
+namespace solitairecpp {
+
+namespace {
+
+// the first solution can't take more than the whole search may
+Solver::Limits firstLimits(const ParSolver::Limits &limits) {
+  auto first = limits.first;
+  first.maxNodes = std::min(first.maxNodes, limits.maxNodes);
+  first.maxTime = std::min(first.maxTime, limits.maxTime);
+  return first;
+}
+
+} // namespace
+
+ParSolver::ParSolver() : ParSolver(Limits{}) {}
+
+ParSolver::ParSolver(const Limits &limits)
+    : limits_{limits}, first_{firstLimits(limits)},
+      table_{limits.memoryBytes} {}
+
+size_t ParSolver::lowerBound(const GameState &state) {
+  size_t bound = GameState::deckSize;
+  for (size_t i{}; i < Piles::foundationsSize; i++)
+    bound -= state.foundation(i).size();
+
+  const size_t drawn =
+      state.mode() == Difficulty::Easy
+          ? 1
+          : GameState::hardDifficultyViewableAmount;
+  bound += (state.stock().size() + drawn - 1) / drawn;
+
+  for (size_t row{}; row < Piles::tableauSize; row++) {
+    // lowest value of every suit seen so far, going up from the bottom
+    std::array<int, static_cast<size_t>(CardType::Count)> lowest;
+    lowest.fill(std::numeric_limits<int>::max());
+    for (const auto card : state.tableauRow(row)) {
+      const auto suit = static_cast<size_t>(card.type());
+      const auto value = static_cast<int>(card.value());
+      if (value > lowest[suit]) {
+        bound++;
+        break;
+      }
+      lowest[suit] = value;
+    }
+  }
+  return bound;
+}
+
+ParSolver::Result ParSolver::solve(const GameState &start,
+                                   std::stop_token stop) {
+  const auto begin = std::chrono::steady_clock::now();
+  Result result;
+  const auto finish = [&](Solver::Status status) {
+    result.status = status;
+    result.elapsed = std::chrono::steady_clock::now() - begin;
+    return result;
+  };
+  if (start.won()) {
+    result.weight = 1;
+    return finish(Solver::Status::Solved);
+  }
+
+  cut_ = false;
+  auto first = first_.solve(start, stop);
+  result.nodes += first.nodes;
+  // no cut moves in Solver either, so there's nothing at all
+  if (first.status == Solver::Status::Unsolvable)
+    return finish(Solver::Status::Unsolvable);
+  result.moves = std::move(first.moves);
+
+  auto weight = std::max(limits_.startWeight, limits_.weight);
+  while (true) {
+    const auto cap = result.moves.empty() ? std::numeric_limits<size_t>::max()
+                                          : result.moves.size();
+    switch (search(start, weight, cap, result, stop, begin)) {
+    case Pass::Found:
+      result.weight = weight;
+      break;
+    case Pass::Exhausted:
+      // nothing shorter at any weight, what's there is the shortest. Unless
+      // unpromising moves got cut, then it's only the best found.
+      if (result.moves.empty())
+        return finish(cut_ ? Solver::Status::Unknown
+                           : Solver::Status::Unsolvable);
+      if (!cut_)
+        result.weight = 1;
+      return finish(Solver::Status::Solved);
+    case Pass::OutOfLimits:
+      return finish(result.moves.empty() ? Solver::Status::Unknown
+                                         : Solver::Status::Solved);
+    }
+
+    if (weight <= limits_.weight)
+      return finish(Solver::Status::Solved);
+    weight = 1 + (weight - 1) / 2;
+    if (weight - limits_.weight < 0.1)
+      weight = limits_.weight;
+  }
+}
+
+ParSolver::Pass ParSolver::search(const GameState &start, double weight,
+                                  size_t cap, Result &result,
+                                  std::stop_token stop,
+                                  std::chrono::steady_clock::time_point begin) {
+  GameState state = start;
+  std::vector<Move> path;
+  const auto expand = [&] {
+    GameState::MoveList moves;
+    const bool afterDraw = !path.empty() && path.back().isDraw();
+    const auto count = Solver::candidates(state, moves, afterDraw,
+                                          limits_.maxRecycles, cut_);
+    frames_.push_back({.offset = moves_.size(), .count = count});
+    moves_.insert(moves_.end(), moves.begin(), moves.begin() + count);
+  };
+
+  constexpr double unbounded = std::numeric_limits<double>::infinity();
+  double threshold = weight * static_cast<double>(lowerBound(state));
+  while (true) {
+    result.iterations++;
+    double next = unbounded;
+    table_.clear();
+    moves_.clear();
+    frames_.clear();
+    table_.improve(Solver::tableKey(state, false), 0);
+    expand();
+
+    while (!frames_.empty()) {
+      auto &frame = frames_.back();
+      if (frame.next == frame.count) {
+        moves_.resize(frame.offset);
+        frames_.pop_back();
+        if (!path.empty()) {
+          state.undo(path.back());
+          path.pop_back();
+        }
+        continue;
+      }
+
+      auto move = moves_[frame.offset + frame.next++];
+      (void)state.apply(move);
+      result.nodes++;
+      if (result.nodes >= limits_.maxNodes ||
+          (result.nodes % 1024 == 0 &&
+           (stop.stop_requested() ||
+            std::chrono::steady_clock::now() - begin >= limits_.maxTime)))
+        return Pass::OutOfLimits;
+
+      // the bound never overestimates, so this can't get under cap anymore
+      const auto depth = path.size() + 1;
+      const auto bound = lowerBound(state);
+      if (depth + bound >= cap) {
+        state.undo(move);
+        continue;
+      }
+
+      const auto f = static_cast<double>(depth) +
+                     weight * static_cast<double>(bound);
+      if (f > threshold) {
+        next = std::min(next, f);
+        state.undo(move);
+        continue;
+      }
+      if (state.won()) {
+        path.push_back(move);
+        result.moves = std::move(path);
+        return Pass::Found;
+      }
+      if (depth > std::numeric_limits<std::uint16_t>::max() ||
+          !table_.improve(Solver::tableKey(state, move.isDraw()),
+                          static_cast<std::uint16_t>(depth))) {
+        state.undo(move);
+        continue;
+      }
+
+      path.push_back(move);
+      expand();
+    }
+
+    // nothing got dropped, so the whole pruned tree is searched
+    if (next == unbounded)
+      return Pass::Exhausted;
+    threshold = next;
+  }
+}
+
+} // namespace solitairecpp
@@ -0,0 +1,201 @@
+#include <algorithm>
+#include <solitairecpp/parallel_solver.hpp>
+#include <thread>
+
+namespace solitairecpp {
+
+ParallelSolver::ParallelSolver(const Solver::Limits &limits, size_t threads)
+    : limits_{limits}, table_{limits.memoryBytes} {
+  for (size_t i{}; i < std::max<size_t>(1, threads); i++)
+    workers_.push_back(std::make_unique<Worker>());
+}
+
+ParallelSolver::Result ParallelSolver::solve(const GameState &state) {
+  table_.clear();
+  root_ = state;
+  begin_ = std::chrono::steady_clock::now();
+  stop_ = false;
+  nodes_ = 0;
+  steals_ = 0;
+  cut_ = false;
+  result_ = {};
+  for (auto &worker : workers_) {
+    worker->path.clear();
+    worker->base = 0;
+    worker->moves.clear();
+    worker->frames.clear();
+    worker->nodes = 0;
+  }
+
+  if (state.won()) {
+    finish(Solver::Status::Solved, &workers_[0]->path);
+  } else {
+    // the first worker starts at the root, the others steal from there
+    auto &first = *workers_[0];
+    first.state = state;
+    table_.insert(Solver::tableKey(state, false));
+    expand(first);
+    active_ = 1;
+
+    std::vector<std::jthread> threads;
+    for (size_t i{1}; i < workers_.size(); i++)
+      threads.emplace_back([this, i] { run(i); });
+    run(0);
+  }
+
+  result_.nodes = nodes_;
+  result_.elapsed = std::chrono::steady_clock::now() - begin_;
+  result_.steals = steals_;
+  for (const auto &worker : workers_)
+    result_.threadNodes.push_back(worker->nodes);
+  return result_;
+}
+
+void ParallelSolver::run(size_t index) {
+  auto &worker = *workers_[index];
+  std::uint64_t pending{}; // nodes not counted in nodes_ yet
+  while (!stop_) {
+    Move move;
+    if (!next(worker, move)) {
+      if (steal(worker, index))
+        continue;
+      if (active_ == 0) {
+        finish(cut_ ? Solver::Status::Unknown : Solver::Status::Unsolvable);
+        break;
+      }
+      std::this_thread::yield();
+      continue;
+    }
+
+    (void)worker.state.apply(move);
+    worker.nodes++;
+    if (++pending == 256) {
+      const auto nodes = nodes_ += pending;
+      pending = 0;
+      if (nodes >= limits_.maxNodes ||
+          std::chrono::steady_clock::now() - begin_ >= limits_.maxTime)
+        finish(Solver::Status::Unknown);
+    }
+
+    if (worker.state.won()) {
+      std::lock_guard lock(worker.mutex);
+      worker.path.push_back(move);
+      finish(Solver::Status::Solved, &worker.path);
+      break;
+    }
+
+    if (!table_.insert(Solver::tableKey(worker.state, move.isDraw()))) {
+      worker.state.undo(move);
+      continue;
+    }
+
+    {
+      std::lock_guard lock(worker.mutex);
+      worker.path.push_back(move);
+    }
+    expand(worker);
+  }
+  nodes_ += pending;
+}
+
+bool ParallelSolver::next(Worker &worker, Move &move) {
+  std::lock_guard lock(worker.mutex);
+  while (!worker.frames.empty()) {
+    auto &frame = worker.frames.back();
+    if (frame.next < frame.count) {
+      move = worker.moves[frame.offset + frame.next++];
+      return true;
+    }
+
+    worker.moves.resize(frame.offset);
+    worker.frames.pop_back();
+    if (worker.frames.empty()) {
+      active_--; // back at the position it started from, nothing left
+      return false;
+    }
+    worker.state.undo(worker.path.back());
+    worker.path.pop_back();
+  }
+  return false;
+}
+
+bool ParallelSolver::steal(Worker &thief, size_t index) {
+  for (size_t offset{1}; offset < workers_.size(); offset++) {
+    auto &victim = *workers_[(index + offset) % workers_.size()];
+    std::vector<Move> path;
+    {
+      std::lock_guard lock(victim.mutex);
+      for (size_t i{}; i < victim.frames.size(); i++) {
+        auto &frame = victim.frames[i];
+        if (frame.next == frame.count)
+          continue;
+
+        path.assign(victim.path.begin(),
+                    victim.path.begin() + victim.base + i);
+        path.push_back(victim.moves[frame.offset + frame.next++]);
+        // counted while the victim still is, so active_ never reads 0 with
+        // work in flight
+        active_++;
+        break;
+      }
+    }
+
+    if (!path.empty()) {
+      steals_++;
+      start(thief, std::move(path));
+      return true;
+    }
+  }
+  return false;
+}
+
+void ParallelSolver::start(Worker &worker, std::vector<Move> path) {
+  worker.state = root_;
+  for (auto &move : path)
+    (void)worker.state.apply(move);
+  worker.nodes++;
+  {
+    std::lock_guard lock(worker.mutex);
+    worker.path = std::move(path);
+    worker.base = worker.path.size();
+  }
+
+  if (worker.state.won()) {
+    finish(Solver::Status::Solved, &worker.path);
+    return;
+  }
+  if (!table_.insert(
+          Solver::tableKey(worker.state, worker.path.back().isDraw()))) {
+    active_--;
+    return;
+  }
+  expand(worker);
+}
+
+void ParallelSolver::expand(Worker &worker) {
+  GameState::MoveList moves;
+  const bool afterDraw = !worker.path.empty() && worker.path.back().isDraw();
+  bool cut{};
+  const auto count = Solver::candidates(worker.state, moves, afterDraw,
+                                        limits_.maxRecycles, cut);
+  if (cut)
+    cut_ = true;
+
+  std::lock_guard lock(worker.mutex);
+  worker.frames.push_back({.offset = worker.moves.size(), .count = count});
+  worker.moves.insert(worker.moves.end(), moves.begin(),
+                      moves.begin() + count);
+}
+
+void ParallelSolver::finish(Solver::Status status,
+                            const std::vector<Move> *path) {
+  std::lock_guard lock(resultMutex_);
+  if (stop_)
+    return; // someone else finished first
+  result_.status = status;
+  if (path != nullptr)
+    result_.moves = *path;
+  stop_ = true;
+}
+
+} // namespace solitairecpp
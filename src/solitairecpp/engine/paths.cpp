@@ -0,0 +1,35 @@
+#include <cstdlib>
+#include <solitairecpp/paths.hpp>
+
+namespace solitairecpp {
+
+std::filesystem::path Paths::dataDirectory() {
+  if (const char *data = std::getenv("XDG_DATA_HOME"); data && *data)
+    return std::filesystem::path(data) / "solitairecpp";
+  if (const char *home = std::getenv("HOME"); home && *home)
+    return std::filesystem::path(home) / ".local" / "share" / "solitairecpp";
+  return ".";
+}
+
+std::filesystem::path Paths::dealDatabase(Difficulty mode) {
+  return dataDirectory() /
+         (mode == Difficulty::Easy ? "deals-easy.db" : "deals-hard.db");
+}
+
+std::filesystem::path Paths::journal() {
+  return dataDirectory() / "last-game.journal";
+}
+
+std::filesystem::path Paths::snapshot() {
+  return dataDirectory() / "saved-game.snapshot";
+}
+
+std::filesystem::path Paths::leaderboard() {
+  return dataDirectory() / "leaderboard.db";
+}
+
+std::filesystem::path Paths::pars() {
+  return dataDirectory() / "pars.db";
+}
+
+} // namespace solitairecpp
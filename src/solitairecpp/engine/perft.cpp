@@ -0,0 +1,50 @@
+#include <atomic>
+#include <solitairecpp/perft.hpp>
+#include <thread>
+
+namespace solitairecpp {
+
+std::uint64_t Perft::count(GameState &state, size_t depth) {
+  if (depth == 0)
+    return 1;
+
+  GameState::MoveList moves;
+  const auto size = state.generateMoves(moves);
+  if (depth == 1)
+    return size;
+
+  std::uint64_t leaves{};
+  for (size_t i{}; i < size; i++) {
+    (void)state.apply(moves[i]);
+    leaves += count(state, depth - 1);
+    state.undo(moves[i]);
+  }
+  return leaves;
+}
+
+std::vector<Perft::RootMove> Perft::divide(const GameState &state,
+                                           size_t depth, size_t threads) {
+  GameState::MoveList moves;
+  const auto size = depth == 0 ? 0 : state.generateMoves(moves);
+  std::vector<RootMove> root(size);
+  for (size_t i{}; i < size; i++)
+    root[i].move = moves[i];
+
+  std::atomic<size_t> next{};
+  const auto work = [&] {
+    for (size_t i = next++; i < root.size(); i = next++) {
+      GameState copy = state;
+      (void)copy.apply(root[i].move);
+      root[i].leaves = count(copy, depth - 1);
+    }
+  };
+
+  std::vector<std::jthread> workers;
+  for (size_t i{1}; i < threads; i++)
+    workers.emplace_back(work);
+  work();
+  workers.clear(); // joins
+  return root;
+}
+
+} // namespace solitairecpp
@@ -0,0 +1,211 @@
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <solitairecpp/mapped_file.hpp>
+#include <solitairecpp/score_table.hpp>
+#include <string_view>
+#include <tuple>
+#include <utility>
+
+namespace solitairecpp {
+
+namespace {
+
+constexpr std::string_view magic = "SCLB";
+constexpr std::uint8_t version = 1;
+
+// callers check the bounds
+std::uint64_t get(const std::byte *in, int bytes) {
+  std::uint64_t value{};
+  for (int i{}; i < bytes; i++)
+    value |= std::to_integer<std::uint64_t>(in[i]) << (8 * i);
+  return value;
+}
+
+void put(std::string &out, std::uint64_t value, int bytes) {
+  for (int i{}; i < bytes; i++)
+    out += static_cast<char>(value >> (8 * i));
+}
+
+std::string header() {
+  std::string bytes(magic);
+  put(bytes, version, 1);
+  put(bytes, 0, 3);
+  return bytes;
+}
+
+void encode(std::string &out, const ScoreTable::Entry &entry) {
+  put(out, entry.dealNumber, 8);
+  put(out, entry.moveCount, 4);
+  put(out, static_cast<std::uint8_t>(entry.mode), 1);
+  put(out, static_cast<std::uint8_t>(entry.parStatus), 1);
+  put(out, entry.par, 2);
+  put(out, static_cast<std::uint64_t>(entry.duration.count()), 4);
+  put(out, 0, 4);
+  put(out, entry.timestamp, 8);
+}
+
+} // namespace
+
+std::optional<long long> ScoreTable::Entry::overPar() const {
+  if (parStatus != Solver::Status::Solved)
+    return std::nullopt;
+  return static_cast<long long>(moveCount) - static_cast<long long>(par);
+}
+
+bool ScoreTable::Ranking::operator()(const Entry &a, const Entry &b) const {
+  // no par sorts last, then by moves, game numbers are unique
+  const auto key = [](const Entry &entry) {
+    const auto overPar = entry.overPar();
+    return std::tuple(!overPar, overPar.value_or(0), entry.moveCount,
+                      entry.gameNumber);
+  };
+  return key(a) < key(b);
+}
+
+ScoreTable::ScoreTable(std::string path) : path_{std::move(path)} {}
+
+std::expected<void, Error> ScoreTable::add(Entry entry) {
+  load();
+  entry.gameNumber = records_++;
+  index(entry);
+
+  if (readOnly_)
+    return std::unexpected(ErrorFile(path_, "not writable").error());
+  if (!out_.is_open()) {
+    auto opened = openForAppend(entry.gameNumber);
+    if (!opened) {
+      readOnly_ = true; // the game numbers in the file would be off
+      return opened;
+    }
+  }
+  std::string record;
+  encode(record, entry);
+  out_.write(record.data(), static_cast<std::streamsize>(record.size()));
+  out_.flush();
+  if (!out_) {
+    readOnly_ = true;
+    return std::unexpected(ErrorFile(path_, "write failed").error());
+  }
+  return std::expected<void, Error>();
+}
+
+size_t ScoreTable::size() {
+  load();
+  return history_.size();
+}
+
+const ScoreTable::Ranked &ScoreTable::ranked() {
+  load();
+  return ranked_;
+}
+
+const ScoreTable::Ranked &ScoreTable::ranked(Difficulty mode,
+                                             std::int64_t week) {
+  static const Ranked none;
+  load();
+  const auto found = weekly_.find({mode, week});
+  return found == weekly_.end() ? none : found->second;
+}
+
+std::optional<ScoreTable::Entry> ScoreTable::best(Difficulty mode,
+                                                  std::uint64_t dealNumber) {
+  load();
+  const auto &deals = bestOnDeal_[static_cast<size_t>(mode)];
+  const auto found = deals.find(dealNumber);
+  if (found == deals.end())
+    return std::nullopt;
+  return found->second;
+}
+
+const std::vector<ScoreTable::Entry> &ScoreTable::history() {
+  load();
+  return history_;
+}
+
+// the epoch was a thursday, three days on from the monday before it
+std::int64_t ScoreTable::week(std::uint64_t timestamp) {
+  return static_cast<std::int64_t>(timestamp / 86400 + 3) / 7;
+}
+
+std::uint64_t ScoreTable::now() {
+  return std::chrono::duration_cast<std::chrono::seconds>(
+             std::chrono::system_clock::now().time_since_epoch())
+      .count();
+}
+
+void ScoreTable::index(const Entry &entry) {
+  ranked_.insert(entry);
+  weekly_[{entry.mode, week(entry.timestamp)}].insert(entry);
+  auto [best, added] = bestOnDeal_[static_cast<size_t>(entry.mode)].try_emplace(
+      entry.dealNumber, entry);
+  if (!added && entry.moveCount < best->second.moveCount)
+    best->second = entry; // par is the same, ties stay with the earlier game
+  history_.push_back(entry);
+}
+
+// A missing or unreadable file is an empty leaderboard, a half written last
+// record is left out
+void ScoreTable::load() {
+  if (std::exchange(loaded_, true))
+    return;
+
+  auto file = MappedFile::open(path_);
+  if (!file)
+    return;
+  const auto bytes = file->bytes();
+  if (bytes.size() < headerSize ||
+      std::memcmp(bytes.data(), magic.data(), magic.size()) != 0 ||
+      std::to_integer<std::uint8_t>(bytes[4]) != version) {
+    readOnly_ = !bytes.empty();
+    return;
+  }
+
+  records_ = (bytes.size() - headerSize) / recordSize;
+  history_.reserve(records_);
+  const auto *in = bytes.data() + headerSize;
+  for (std::uint64_t i{}; i < records_; i++, in += recordSize) {
+    const auto mode = get(in + 12, 1);
+    const auto status = get(in + 13, 1);
+    if (mode > static_cast<std::uint8_t>(Difficulty::Hard) ||
+        status > static_cast<std::uint8_t>(Solver::Status::Unknown))
+      continue; // garbage, but the game numbers after it still count
+    Entry entry{.gameNumber = i,
+                .dealNumber = get(in, 8),
+                .moveCount = static_cast<std::uint32_t>(get(in + 8, 4)),
+                .mode = static_cast<Difficulty>(mode),
+                .parStatus = static_cast<Solver::Status>(status),
+                .par = static_cast<std::uint16_t>(get(in + 14, 2)),
+                .duration = std::chrono::milliseconds(get(in + 16, 4)),
+                .timestamp = get(in + 24, 8)};
+    index(entry);
+  }
+}
+
+// Starts the file when there is none and cuts off a half written last
+// record, appending after it would shift every record that follows
+std::expected<void, Error> ScoreTable::openForAppend(std::uint64_t records) {
+  const auto path = std::filesystem::path(path_);
+  std::error_code error;
+  if (path.has_parent_path())
+    std::filesystem::create_directories(path.parent_path(), error);
+
+  if (records == 0) {
+    std::ofstream file(path_, std::ios::binary | std::ios::trunc);
+    file << header();
+    if (!file)
+      return std::unexpected(ErrorFile(path_, "can't create").error());
+  } else {
+    std::filesystem::resize_file(path, headerSize + records * recordSize,
+                                 error);
+    if (error)
+      return std::unexpected(ErrorFile(path_, error.message()).error());
+  }
+
+  out_.open(path_, std::ios::binary | std::ios::app);
+  if (!out_)
+    return std::unexpected(ErrorFile(path_, "can't open").error());
+  return std::expected<void, Error>();
+}
+
+} // namespace solitairecpp
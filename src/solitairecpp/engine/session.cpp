@@ -0,0 +1,66 @@
+#include <random>
+#include <solitairecpp/session.hpp>
+
+namespace solitairecpp {
+
+Session::Session(Difficulty mode) : Session(mode, randomDealNumber()) {}
+
+Session::Session(Difficulty mode, std::uint64_t dealNumber,
+                 size_t historyCapacity)
+    : state_{mode, dealNumber}, history_{historyCapacity} {}
+
+Session::Session(const GameState &state, MoveLog history, size_t moveCount)
+    : state_{state}, history_{std::move(history)}, moveCount_{moveCount} {}
+
+std::uint64_t Session::randomDealNumber() {
+  std::random_device rd;
+  return (static_cast<std::uint64_t>(rd()) << 32) | rd();
+}
+
+const GameState &Session::state() const { return state_; }
+
+std::expected<void, ErrorCode> Session::apply(Move &move) {
+  auto success = state_.apply(move);
+  if (!success)
+    return std::unexpected(success.error());
+
+  history_.push(move);
+  moveCount_++;
+  return std::expected<void, ErrorCode>();
+}
+
+std::expected<Move, ErrorCode> Session::undo() {
+  auto move = history_.undo();
+  if (!move)
+    return std::unexpected(ErrorCode::NothingToUndo);
+
+  state_.undo(move.value());
+  moveCount_--;
+  return move.value();
+}
+
+std::expected<Move, ErrorCode> Session::redo() {
+  auto move = history_.redo();
+  if (!move)
+    return std::unexpected(ErrorCode::NothingToRedo);
+
+  // the state is exactly the one the move was first applied to, recycles
+  // included, so this can't fail and the flags come out the same
+  auto success = state_.apply(move.value());
+  if (!success) {
+    history_.undo(); // put it back on the redo side
+    return std::unexpected(success.error());
+  }
+  moveCount_++;
+  return move.value();
+}
+
+bool Session::canUndo() const { return history_.undoSize() != 0; }
+
+bool Session::canRedo() const { return history_.redoSize() != 0; }
+
+size_t Session::moveCount() const { return moveCount_; }
+
+const MoveLog &Session::history() const { return history_; }
+
+} // namespace solitairecpp
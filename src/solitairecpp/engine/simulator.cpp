@@ -0,0 +1,201 @@
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <mutex>
+#include <solitairecpp/auto_complete.hpp>
+#include <solitairecpp/random.hpp>
+#include <solitairecpp/simulator.hpp>
+#include <thread>
+
+namespace solitairecpp {
+
+void Simulator::Stats::add(bool won, size_t moveCount,
+                           std::chrono::nanoseconds elapsed) {
+  games++;
+  if (won) {
+    wins++;
+    wonMoves += moveCount;
+    moves[std::min(moveCount / moveBucketWidth, moveBuckets - 1)]++;
+  }
+
+  time += elapsed;
+  slowest = std::max(slowest, elapsed);
+  const auto microseconds =
+      std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+  const size_t bucket = std::bit_width(static_cast<std::uint64_t>(
+      std::max<std::int64_t>(0, microseconds)));
+  times[std::min(bucket, timeBuckets - 1)]++;
+}
+
+void Simulator::Stats::merge(const Stats &other) {
+  games += other.games;
+  wins += other.wins;
+  wonMoves += other.wonMoves;
+  for (size_t i{}; i < moveBuckets; i++)
+    moves[i] += other.moves[i];
+  time += other.time;
+  slowest = std::max(slowest, other.slowest);
+  for (size_t i{}; i < timeBuckets; i++)
+    times[i] += other.times[i];
+}
+
+double Simulator::Stats::winRate() const {
+  return games == 0 ? 0 : static_cast<double>(wins) / games;
+}
+
+double Simulator::Stats::averageMoves() const {
+  return wins == 0 ? 0 : static_cast<double>(wonMoves) / wins;
+}
+
+std::chrono::microseconds Simulator::Stats::timePercentile(double share) const {
+  const auto wanted = static_cast<std::uint64_t>(share * games);
+  std::uint64_t counted{};
+  for (size_t i{}; i < timeBuckets; i++) {
+    counted += times[i];
+    if (counted >= wanted && counted != 0)
+      return std::chrono::microseconds(std::uint64_t{1} << i);
+  }
+  return {};
+}
+
+Simulator::Simulator(const Options &options) : options_{options} {}
+
+Simulator::Stats Simulator::run(const Progress &progress) {
+  const std::uint64_t total = options_.games;
+  const size_t threadCount = std::max<size_t>(1, options_.threads);
+  std::atomic<std::uint64_t> next{};
+  std::atomic<std::uint64_t> finished{};
+  std::atomic<size_t> running{threadCount};
+  std::mutex statsMutex;
+  Stats stats;
+
+  const auto work = [&] {
+    Player player{.solver = Solver(options_.limits), .seen = {}};
+    Stats local;
+    for (std::uint64_t begin = next.fetch_add(chunkSize_); begin < total;
+         begin = next.fetch_add(chunkSize_)) {
+      const auto end = std::min(total, begin + chunkSize_);
+      for (std::uint64_t deal = begin; deal < end; deal++) {
+        const auto start = std::chrono::steady_clock::now();
+        Session session(options_.mode, deal);
+        const bool won = play(player, session);
+        local.add(won, session.moveCount(),
+                  std::chrono::steady_clock::now() - start);
+      }
+      finished += end - begin;
+    }
+
+    std::lock_guard lock(statsMutex);
+    stats.merge(local);
+    running--;
+  };
+
+  {
+    std::vector<std::jthread> threads;
+    for (size_t i{}; i < threadCount; i++)
+      threads.emplace_back(work);
+
+    auto lastReport = std::chrono::steady_clock::now();
+    while (running > 0) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(50));
+      if (progress &&
+          std::chrono::steady_clock::now() - lastReport >=
+              std::chrono::seconds(1)) {
+        progress(finished, total);
+        lastReport = std::chrono::steady_clock::now();
+      }
+    }
+  }
+  if (progress)
+    progress(finished, total);
+  return stats;
+}
+
+std::optional<Simulator::Agent> Simulator::parseAgent(std::string_view name) {
+  if (name == "random")
+    return Agent::Random;
+  if (name == "greedy")
+    return Agent::Greedy;
+  if (name == "solver")
+    return Agent::Solver;
+  return std::nullopt;
+}
+
+bool Simulator::play(Player &player, Session &session) const {
+  switch (options_.agent) {
+  case Agent::Random:
+    return playRandom(session);
+  case Agent::Greedy:
+    return playGreedy(player, session);
+  case Agent::Solver:
+    return playSolver(player, session);
+  }
+  return false;
+}
+
+bool Simulator::playRandom(Session &session) const {
+  SplitMix64 random(SplitMix64::mix(session.state().dealNumber()));
+  GameState::MoveList moves;
+  while (!session.state().won() && session.moveCount() < options_.maxMoves) {
+    const auto count = session.state().generateMoves(moves);
+    if (count == 0 || !session.apply(moves[random.below(count)]))
+      return false;
+  }
+  return session.state().won();
+}
+
+// Takes the best ranked move that leads somewhere new, so it can't go round
+// in circles. Finishes with auto-complete once the game is decided, like a
+// player pressing the button would. The game has no recycle limit, so
+// neither does it, maxMoves ends the hopeless games.
+bool Simulator::playGreedy(Player &player, Session &session) const {
+  auto &seen = player.seen;
+  seen.clear();
+  seen.insert(session.state().hash());
+
+  GameState::MoveList moves;
+  std::array<std::pair<Solver::Rank, size_t>, GameState::maxMoves> ranked;
+  while (!session.state().won() && session.moveCount() < options_.maxMoves) {
+    if (AutoComplete::decided(session.state())) {
+      AutoComplete::run(session);
+      break;
+    }
+
+    const auto &state = session.state();
+    const auto count = state.generateMoves(moves);
+    for (size_t i{}; i < count; i++)
+      // it never goes back to before a draw, so nothing counts as searched
+      // in the other order
+      ranked[i] = {Solver::rank(state, moves[i], false, noRecycleLimit_), i};
+    std::sort(ranked.begin(), ranked.begin() + count);
+
+    std::optional<Move> chosen;
+    GameState scratch = state;
+    for (size_t i{}; i < count && !chosen; i++) {
+      if (ranked[i].first == Solver::Rank::Useless)
+        break;
+      auto move = moves[ranked[i].second];
+      if (!scratch.apply(move))
+        continue;
+      if (!seen.contains(scratch.hash()))
+        chosen = move;
+      scratch.undo(move);
+    }
+    if (!chosen || !session.apply(chosen.value()))
+      return false;
+    seen.insert(session.state().hash());
+  }
+  return session.state().won();
+}
+
+bool Simulator::playSolver(Player &player, Session &session) const {
+  auto result = player.solver.solve(session.state());
+  if (result.status != Solver::Status::Solved)
+    return false;
+  for (auto &move : result.moves)
+    if (!session.apply(move))
+      return false;
+  return session.state().won();
+}
+
+} // namespace solitairecpp
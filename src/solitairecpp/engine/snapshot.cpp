@@ -0,0 +1,203 @@
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <filesystem>
+#include <solitairecpp/mapped_file.hpp>
+#include <solitairecpp/snapshot.hpp>
+#include <span>
+#include <string_view>
+#include <unistd.h>
+
+namespace solitairecpp {
+
+namespace {
+
+constexpr std::string_view magic = "SCSN";
+constexpr std::uint8_t version = 1;
+constexpr size_t moveSize = 4;
+constexpr size_t checksumSize = 8;
+
+template <typename T> void put(std::string &out, T value, int bytes) {
+  for (int i{}; i < bytes; i++)
+    out += static_cast<char>(static_cast<std::uint64_t>(value) >> (8 * i));
+}
+
+// callers check the bounds
+std::uint64_t get(const std::byte *in, int bytes) {
+  std::uint64_t value{};
+  for (int i{}; i < bytes; i++)
+    value |= std::to_integer<std::uint64_t>(in[i]) << (8 * i);
+  return value;
+}
+
+std::uint64_t fnv1a(std::span<const std::byte> bytes) {
+  std::uint64_t hash = 0xCBF29CE484222325ULL;
+  for (const auto byte : bytes)
+    hash = (hash ^ std::to_integer<std::uint64_t>(byte)) * 0x100000001B3ULL;
+  return hash;
+}
+
+} // namespace
+
+size_t Snapshot::size(const Session &session) {
+  const auto &history = session.history();
+  return headerSize + GameState::deckSize +
+         (history.undoSize() + history.redoSize()) * moveSize + checksumSize;
+}
+
+std::expected<void, Error> Snapshot::write(const std::string &path,
+                                           const Session &session,
+                                           const Progress &progress) {
+  std::string bytes;
+  encode(session, progress, bytes);
+  return store(path, bytes);
+}
+
+void Snapshot::encode(const Session &session, const Progress &progress,
+                      std::string &out) {
+  const auto &state = session.state();
+  const auto &history = session.history();
+  out.clear();
+  out.reserve(size(session));
+
+  out += magic;
+  put(out, version, 1);
+  put(out, static_cast<std::uint8_t>(state.mode()), 1);
+  put(out, state.recycles(), 2);
+  put(out, state.dealNumber(), 8);
+  put(out, session.moveCount(), 4);
+  put(out, history.undoSize(), 4);
+  put(out, history.redoSize(), 4);
+  for (PileId pile{}; pile < Piles::count; pile++)
+    put(out, state.pileSize(pile), 1);
+  put(out, 0, 3);
+  put(out, progress.journalRecords, 4);
+  put(out, progress.playTime.count(), 8);
+
+  for (PileId pile{}; pile < Piles::count; pile++)
+    for (size_t depth{}; depth < state.pileSize(pile); depth++)
+      put(out, state.pileCard(pile, depth).bits(), 1);
+  for (size_t i{}; i < history.undoSize() + history.redoSize(); i++) {
+    const auto &move = history.at(i);
+    out += {static_cast<char>(move.from), static_cast<char>(move.to),
+            static_cast<char>(move.count), static_cast<char>(move.flags)};
+  }
+  put(out, fnv1a(std::as_bytes(std::span(out))), 8);
+}
+
+std::expected<void, Error> Snapshot::store(const std::string &path,
+                                           std::string_view bytes) {
+  const auto target = std::filesystem::path(path);
+  std::error_code error;
+  if (target.has_parent_path())
+    std::filesystem::create_directories(target.parent_path(), error);
+
+  const auto temporary = path + ".tmp";
+  const auto failed = [&](const std::string &file) {
+    return std::unexpected(ErrorFile(file, std::strerror(errno)).error());
+  };
+  const int fd = ::open(temporary.c_str(),
+                        O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if (fd < 0)
+    return failed(temporary);
+  for (size_t written{}; written < bytes.size();) {
+    const auto result =
+        ::write(fd, bytes.data() + written, bytes.size() - written);
+    if (result < 0 && errno == EINTR)
+      continue;
+    if (result < 0) {
+      auto failure = failed(temporary);
+      ::close(fd);
+      return failure;
+    }
+    written += static_cast<size_t>(result);
+  }
+  // the data has to be on disk before the rename makes it the snapshot
+  if (::fsync(fd) != 0) {
+    auto failure = failed(temporary);
+    ::close(fd);
+    return failure;
+  }
+  ::close(fd);
+
+  if (::rename(temporary.c_str(), path.c_str()) != 0)
+    return failed(path);
+  // and the rename itself has to survive a crash too
+  const auto directory =
+      target.has_parent_path() ? target.parent_path().string() : ".";
+  if (const int dir = ::open(directory.c_str(), O_RDONLY | O_CLOEXEC);
+      dir >= 0) {
+    ::fsync(dir);
+    ::close(dir);
+  }
+  return std::expected<void, Error>();
+}
+
+std::expected<Snapshot::Loaded, Error> Snapshot::load(const std::string &path) {
+  auto file = MappedFile::open(path);
+  if (!file)
+    return std::unexpected(file.error());
+
+  const auto bytes = file->bytes();
+  const auto bad = [&](const char *reason) {
+    return std::unexpected(ErrorFile(path, reason).error());
+  };
+  if (bytes.size() < headerSize + GameState::deckSize + checksumSize ||
+      std::memcmp(bytes.data(), magic.data(), magic.size()) != 0)
+    return bad("not a snapshot");
+  if (std::to_integer<std::uint8_t>(bytes[4]) != version)
+    return bad("unsupported snapshot version");
+
+  const auto *in = bytes.data();
+  const auto mode = get(in + 5, 1);
+  const auto recycles = get(in + 6, 2);
+  const auto dealNumber = get(in + 8, 8);
+  const auto moveCount = get(in + 16, 4);
+  const auto undoSize = get(in + 20, 4);
+  const auto redoSize = get(in + 24, 4);
+  const auto moves = undoSize + redoSize;
+  const Progress progress = {
+      .journalRecords = static_cast<std::uint32_t>(get(in + 44, 4)),
+      .playTime = std::chrono::milliseconds(get(in + 48, 8))};
+  if (mode > static_cast<std::uint8_t>(Difficulty::Hard))
+    return bad("unknown mode");
+  if (moves > MoveLog::defaultCapacity ||
+      bytes.size() != headerSize + GameState::deckSize + moves * moveSize +
+                          checksumSize)
+    return bad("truncated snapshot");
+  const auto body = bytes.first(bytes.size() - checksumSize);
+  if (fnv1a(body) != get(body.data() + body.size(), 8))
+    return bad("corrupt snapshot");
+
+  std::array<std::uint8_t, Piles::count> sizes;
+  for (PileId pile{}; pile < Piles::count; pile++)
+    sizes[pile] = static_cast<std::uint8_t>(get(in + 28 + pile, 1));
+  std::array<PackedCard, GameState::deckSize> cards;
+  std::memcpy(cards.data(), in + headerSize, cards.size());
+  auto state = GameState::restore(static_cast<Difficulty>(mode), dealNumber,
+                                  recycles, sizes, cards);
+  if (!state)
+    return bad("cards don't add up to a deck");
+
+  // the redoable moves go back to the redo side the way they came
+  MoveLog history;
+  const auto *log = in + headerSize + GameState::deckSize;
+  for (size_t i{}; i < moves; i++, log += moveSize) {
+    const Move move{.from = static_cast<PileId>(get(log, 1)),
+                    .to = static_cast<PileId>(get(log + 1, 1)),
+                    .count = static_cast<std::uint8_t>(get(log + 2, 1)),
+                    .flags = static_cast<std::uint8_t>(get(log + 3, 1))};
+    if (move.from >= Piles::count || move.to >= Piles::count)
+      return bad("bad move in the undo log");
+    history.push(move);
+  }
+  for (size_t i{}; i < redoSize; i++)
+    history.undo();
+
+  return Loaded{.session = Session(state.value(), std::move(history),
+                                   moveCount),
+                .progress = progress};
+}
+
+} // namespace solitairecpp
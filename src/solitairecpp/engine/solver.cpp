@@ -0,0 +1,180 @@
+#include <algorithm>
+#include <solitairecpp/solver.hpp>
+
+namespace solitairecpp {
+
+Solver::Solver() : Solver(Limits{}) {}
+
+Solver::Solver(const Limits &limits)
+    : limits_{limits}, table_{limits.memoryBytes} {}
+
+Solver::Rank Solver::rank(const GameState &state, const Move &move,
+                         bool afterDraw, size_t maxRecycles) {
+  if (move.isDraw())
+    return state.stock().empty() && state.recycles() >= maxRecycles
+               ? Rank::Unpromising // more reshuffles could still win
+               : Rank::Draw;
+  if (move.from == Piles::waste)
+    return Piles::isFoundation(move.to) ? Rank::Foundation : Rank::FromWaste;
+
+  // A draw and a tableau move don't touch the same piles, so they can be
+  // swapped. The order with the tableau move first gets searched, from the
+  // position before the draw. Only a split that frees a spot for the card
+  // just drawn can be new, before the draw the waste had another top.
+  const auto &row = state.tableauRow(move.from);
+  const size_t start = row.size() - move.count;
+  const bool reveals = start > 0 && row.at(start - 1).faceDown();
+  if (Piles::isFoundation(move.to))
+    return afterDraw ? Rank::Useless
+           : reveals ? Rank::Reveal
+                     : Rank::Foundation;
+
+  if (reveals)
+    return afterDraw ? Rank::Useless : Rank::Reveal;
+  if (start == 0) // a king run moving between empty rows goes nowhere
+    return afterDraw || state.tableauRow(move.to).empty() ? Rank::Useless
+                                                          : Rank::EmptyRow;
+
+  // splitting a run helps when the card it frees can go somewhere or take
+  // something
+  const auto exposed = row.at(start - 1);
+  const auto takes = [&](PackedCard card) {
+    return card.color() != exposed.color() &&
+           static_cast<int>(card.value()) + 1 ==
+               static_cast<int>(exposed.value());
+  };
+  const auto &waste = state.waste();
+  if (!waste.empty() && takes(waste.back()))
+    return Rank::Shuffle;
+  // anything else was ranked the same before the draw
+  if (afterDraw)
+    return Rank::Useless;
+  for (size_t i{}; i < Piles::foundationsSize; i++)
+    if (state.isSetLegal(i, exposed))
+      return Rank::Shuffle;
+  // a run of another row can move onto it, turning up the card under it or
+  // emptying the row
+  for (size_t other{}; other < Piles::tableauSize; other++) {
+    if (other == move.from)
+      continue;
+    const auto &cards = state.tableauRow(other);
+    for (size_t i{}; i < cards.size(); i++) {
+      if (cards.at(i).faceDown() || !takes(cards.at(i)))
+        continue;
+      if (i == 0 || cards.at(i - 1).faceDown())
+        return Rank::Shuffle;
+      break; // a run only has one card of each value
+    }
+  }
+  return Rank::Unpromising;
+}
+
+size_t Solver::candidates(const GameState &state, GameState::MoveList &moves,
+                          bool afterDraw, size_t maxRecycles, bool &cut) {
+  const auto count = state.generateMoves(moves);
+  // foundation moves come first, a safe one is the only candidate
+  for (size_t i{}; i < count && Piles::isFoundation(moves[i].to); i++) {
+    if (state.isSafeFoundationMove(moves[i])) {
+      moves[0] = moves[i];
+      return 1;
+    }
+  }
+
+  std::array<Rank, GameState::maxMoves> ranks;
+  size_t kept{};
+  for (size_t i{}; i < count; i++) {
+    const auto moveRank = rank(state, moves[i], afterDraw, maxRecycles);
+    if (moveRank >= Rank::Unpromising) {
+      cut |= moveRank == Rank::Unpromising;
+      continue;
+    }
+    ranks[kept] = moveRank;
+    moves[kept++] = moves[i];
+  }
+
+  // insertion sort, there's rarely more than a dozen
+  for (size_t i{1}; i < kept; i++) {
+    for (size_t j{i}; j > 0 && ranks[j] < ranks[j - 1]; j--) {
+      std::swap(ranks[j], ranks[j - 1]);
+      std::swap(moves[j], moves[j - 1]);
+    }
+  }
+  return kept;
+}
+
+std::uint64_t Solver::tableKey(const GameState &state, bool afterDraw) {
+  // reached by a draw the position gets fewer candidates, so it counts as a
+  // different one
+  constexpr std::uint64_t afterDrawKey = SplitMix64::mix(0xD4A3);
+  return state.hash() ^ (afterDraw ? afterDrawKey : 0);
+}
+
+Solver::Result Solver::solve(const GameState &start, std::stop_token stop) {
+  const auto begin = std::chrono::steady_clock::now();
+  Result result;
+  table_.clear();
+  moves_.clear();
+  frames_.clear();
+
+  GameState state = start;
+  std::vector<Move> path;
+  bool cut{}; // then running out of moves proves nothing
+  const auto expand = [&] {
+    GameState::MoveList moves;
+    const bool afterDraw = !path.empty() && path.back().isDraw();
+    const auto count =
+        candidates(state, moves, afterDraw, limits_.maxRecycles, cut);
+    frames_.push_back({.offset = moves_.size(), .count = count});
+    moves_.insert(moves_.end(), moves.begin(), moves.begin() + count);
+  };
+
+  const auto finish = [&](Status status) {
+    result.status = status;
+    result.elapsed = std::chrono::steady_clock::now() - begin;
+    if (status == Status::Solved)
+      result.moves = path;
+    return result;
+  };
+
+  if (state.won())
+    return finish(Status::Solved);
+  table_.insert(tableKey(state, false));
+  expand();
+
+  while (true) {
+    auto &frame = frames_.back();
+    if (frame.next == frame.count) {
+      moves_.resize(frame.offset);
+      frames_.pop_back();
+      if (path.empty())
+        return finish(cut ? Status::Unknown : Status::Unsolvable);
+      state.undo(path.back());
+      path.pop_back();
+      continue;
+    }
+
+    auto move = moves_[frame.offset + frame.next++];
+    (void)state.apply(move);
+    result.nodes++;
+    if (state.won()) {
+      path.push_back(move);
+      return finish(Status::Solved);
+    }
+
+    if (result.nodes >= limits_.maxNodes ||
+        (result.nodes % 1024 == 0 &&
+         (stop.stop_requested() ||
+          std::chrono::steady_clock::now() - begin >= limits_.maxTime)))
+      return finish(Status::Unknown);
+
+    if (!table_.insert(tableKey(state, move.isDraw()))) {
+      state.undo(move);
+      continue;
+    }
+
+    path.push_back(move);
+    expand();
+  }
+}
+
+} // namespace solitairecpp
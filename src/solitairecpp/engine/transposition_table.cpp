@@ -0,0 +1,80 @@
+#include <algorithm>
+#include <bit>
+#include <solitairecpp/transposition_table.hpp>
+
+namespace solitairecpp {
+
+namespace {
+
+size_t bucketCount(size_t bytes, size_t bucketSize) {
+  return std::bit_floor(
+      std::max<size_t>(1, bytes / sizeof(std::uint64_t) / bucketSize));
+}
+
+} // namespace
+
+TranspositionTable::TranspositionTable(size_t bytes)
+    : entries_(bucketCount(bytes, bucketSize_) * bucketSize_),
+      mask_{bucketCount(bytes, bucketSize_) - 1} {}
+
+bool TranspositionTable::insert(std::uint64_t hash) {
+  auto *bucket = entries_.data() + (hash & mask_) * bucketSize_;
+  const auto tagged = (hash & ~generationMask_) | generation_;
+  for (size_t i{}; i < bucketSize_; i++) {
+    auto entry = bucket[i].load(std::memory_order_relaxed);
+    if (entry == tagged)
+      return false;
+    if ((entry & generationMask_) != generation_ &&
+        bucket[i].compare_exchange_strong(entry, tagged,
+                                          std::memory_order_relaxed))
+      return true;
+    // lost the slot, maybe to a thread inserting this hash
+    if (entry == tagged)
+      return false;
+  }
+
+  // full, the top bits pick who goes
+  static_assert(bucketSize_ == 4);
+  bucket[hash >> 62].store(tagged, std::memory_order_relaxed);
+  return true;
+}
+
+bool TranspositionTable::improve(std::uint64_t hash, std::uint16_t depth) {
+  auto *bucket = entries_.data() + (hash & mask_) * bucketSize_;
+  const auto key = hash & keyMask_;
+  const auto tagged =
+      key | std::uint64_t{depth} << depthShift_ | generation_;
+  for (size_t i{}; i < bucketSize_; i++) {
+    auto entry = bucket[i].load(std::memory_order_relaxed);
+    while (true) {
+      const bool current = (entry & generationMask_) == generation_;
+      if (current && (entry & keyMask_) != key)
+        break; // someone else's
+      if (current && (entry >> depthShift_ & 0xFFFF) <= depth)
+        return false;
+      // an empty slot or a deeper visit of this position, a failed exchange
+      // reloads the entry and looks again
+      if (bucket[i].compare_exchange_weak(entry, tagged,
+                                          std::memory_order_relaxed))
+        return true;
+    }
+  }
+
+  static_assert(bucketSize_ == 4);
+  bucket[hash >> 62].store(tagged, std::memory_order_relaxed);
+  return true;
+}
+
+void TranspositionTable::clear() {
+  if (++generation_ <= generationMask_)
+    return;
+
+  // wrapped around, old entries could look current again
+  for (auto &entry : entries_)
+    entry.store(0, std::memory_order_relaxed);
+  generation_ = 1;
+}
+
+size_t TranspositionTable::capacity() const { return entries_.size(); }
+
+} // namespace solitairecpp
@@ -0,0 +1,92 @@
+#include <algorithm>
+#include <solitairecpp/win_estimator.hpp>
+
+namespace solitairecpp {
+
+double WinEstimator::Estimate::probability() const {
+  return rollouts == 0 ? 0.0
+                       : static_cast<double>(wins) /
+                             static_cast<double>(rollouts);
+}
+
+WinEstimator::WinEstimator(size_t threads, size_t maxRollouts,
+                           const Solver::Limits &limits, Progress progress)
+    : limits_{limits}, maxRollouts_{maxRollouts},
+      progress_{std::move(progress)} {
+  for (size_t i{}; i < std::max<size_t>(1, threads); i++)
+    threads_.emplace_back([this](std::stop_token stop) { run(stop); });
+}
+
+WinEstimator::~WinEstimator() {
+  stop();
+  for (auto &thread : threads_)
+    thread.request_stop();
+  threads_.clear(); // joins, before the members the threads use go away
+}
+
+void WinEstimator::estimate(const GameState &state) {
+  {
+    std::lock_guard lock(mutex_);
+    position_.request_stop();
+    position_ = std::stop_source();
+    state_ = state;
+    active_ = true;
+    generation_++;
+    started_ = 0;
+    estimate_ = {};
+  }
+  wake_.notify_all();
+}
+
+void WinEstimator::stop() {
+  std::lock_guard lock(mutex_);
+  position_.request_stop();
+  active_ = false;
+}
+
+WinEstimator::Estimate WinEstimator::current() const {
+  std::lock_guard lock(mutex_);
+  return estimate_;
+}
+
+void WinEstimator::run(std::stop_token stop) {
+  Solver solver(limits_);
+  while (true) {
+    GameState state;
+    std::uint64_t generation{};
+    std::uint64_t rollout{};
+    std::stop_token positionStop;
+    {
+      std::unique_lock lock(mutex_);
+      if (!wake_.wait(lock, stop,
+                      [&] { return active_ && started_ < maxRollouts_; }))
+        return; // the pool is going away
+      state = state_;
+      generation = generation_;
+      rollout = started_++;
+      positionStop = position_.get_token();
+    }
+
+    const auto sample = state.sample(
+        SplitMix64::mix(generation ^ SplitMix64::mix(rollout)));
+    const auto result = solver.solve(sample, positionStop);
+    if (positionStop.stop_requested())
+      continue; // cut short, the position is gone anyway
+
+    bool report{};
+    {
+      std::lock_guard lock(mutex_);
+      if (generation != generation_)
+        continue;
+      estimate_.rollouts++;
+      if (result.status == Solver::Status::Solved)
+        estimate_.wins++;
+      report = estimate_.rollouts % progressInterval_ == 0 ||
+               estimate_.rollouts == maxRollouts_;
+    }
+    if (report && progress_)
+      progress_();
+  }
+}
+
+} // namespace solitairecpp
@@ -1,45 +1,215 @@
+#include <algorithm>
+#include <chrono>
 #include <ftxui/component/component.hpp>
 #include <ftxui/component/screen_interactive.hpp>
 #include <ftxui/dom/elements.hpp>
+#include <format>
 #include <ftxui/dom/table.hpp>
+#include <memory>
 #include <solitairecpp/leaderboard.hpp>
 #include <solitairecpp/utils.hpp>
 #include <string>
+#include <utility>
+#include <vector>
 
 namespace solitairecpp {
 
-void Leaderboard::registerScore(size_t moveCount) {
-  leaderboard_.emplace_back(leaderboard_.size(), moveCount);
-  std::sort(leaderboard_.begin(), leaderboard_.end(),
-            [](auto a, auto b) { return a.moveCount < b.moveCount; });
+Leaderboard::Leaderboard(const ParPool &par, std::string path)
+    : par_{&par}, scores_{std::move(path)} {}
+
+void Leaderboard::registerScore(size_t moveCount, Difficulty mode,
+                                std::uint64_t dealNumber,
+                                std::chrono::milliseconds duration) {
+  ScoreTable::Entry entry{
+      .dealNumber = dealNumber,
+      .moveCount = static_cast<std::uint32_t>(moveCount),
+      .mode = mode,
+      .duration = duration,
+      .timestamp = ScoreTable::now()};
+  if (auto par = par_->find(mode, dealNumber)) {
+    entry.parStatus = par->status;
+    entry.par = static_cast<std::uint16_t>(
+        std::min<size_t>(par->moves, UINT16_MAX));
+  }
+  // a score that can't be saved still shows until the game is closed
+  (void)scores_.add(entry);
 }
 
-ft::Component Leaderboard::component() {
+std::optional<size_t> Leaderboard::best(Difficulty mode,
+                                        std::uint64_t dealNumber) {
+  return scores_.best(mode, dealNumber).transform(
+      [](const ScoreTable::Entry &entry) -> size_t { return entry.moveCount; });
+}
+
+namespace {
+
+enum class View { Best, EasyWeek, HardWeek, History };
+
+const std::vector<std::string> viewNames = {"Best", "Easy this week",
+                                            "Hard this week", "History"};
+
+// The view and page shown, and the table of it
+struct Pages {
+  int view{};
+  size_t page{};
+  // first entry of every page reached so far, ranked views only. Walking
+  // the set a page at a time keeps a page O(log n + rows).
+  std::vector<ScoreTable::Ranked::const_iterator> starts;
+  bool last{};
+  size_t total{}; // games in the view
+  ft::Element table;
+};
+
+std::string duration(std::chrono::milliseconds duration) {
+  const auto seconds = duration.count() / 1000;
+  return std::format("{}:{:02}", seconds / 60, seconds % 60);
+}
+
+std::string date(std::uint64_t timestamp) {
+  const std::chrono::year_month_day day{std::chrono::floor<std::chrono::days>(
+      std::chrono::sys_seconds(std::chrono::seconds(timestamp)))};
+  return std::format("{:04}-{:02}-{:02}", static_cast<int>(day.year()),
+                     static_cast<unsigned>(day.month()),
+                     static_cast<unsigned>(day.day()));
+}
+
+ft::Element table(const std::vector<ScoreTable::Entry> &entries,
+                  size_t first) {
   std::vector<std::vector<std::string>> tableInput;
-  tableInput.reserve(leaderboard_.size());
-  tableInput.push_back({"Game ID", "Move count"}); // header
-  for (const auto &entry : leaderboard_)
+  tableInput.reserve(entries.size() + 1);
+  tableInput.push_back({"#", "Game ID", "Mode", "Deal", "Move count", "Par",
+                        "Over par", "Time", "Won on"}); // header
+  for (const auto &entry : entries) {
+    std::string par = "?"; // wasn't worked out yet when the game was won
+    std::string overPar = "?";
+    if (const auto over = entry.overPar()) {
+      par = std::to_string(entry.par);
+      overPar = std::format("{:+}", over.value());
+    } else if (entry.parStatus != Solver::Status::Unknown) {
+      par = overPar = "-"; // the solver didn't find a win
+    }
     tableInput.push_back(
-        {std::to_string(entry.gameNumber), std::to_string(entry.moveCount)});
+        {std::to_string(first + tableInput.size()),
+         std::to_string(entry.gameNumber),
+         entry.mode == Difficulty::Easy ? "Easy" : "Hard",
+         std::to_string(entry.dealNumber), std::to_string(entry.moveCount),
+         par, overPar, duration(entry.duration), date(entry.timestamp)});
+  }
 
   auto leaderboardTable = ft::Table(tableInput);
   leaderboardTable.SelectAll().Border(ft::ROUNDED);
   leaderboardTable.SelectRow(0).Decorate(ft::bold);
-  leaderboardTable.SelectColumns(0, 1).SeparatorHorizontal(ft::HEAVY);
-  leaderboardTable.SelectColumns(0, 1).SeparatorVertical(ft::HEAVY);
-  auto leaderboardElement = leaderboardTable.Render();
+  leaderboardTable.SelectColumns(0, 8).SeparatorHorizontal(ft::HEAVY);
+  leaderboardTable.SelectColumns(0, 8).SeparatorVertical(ft::HEAVY);
+  return leaderboardTable.Render();
+}
+
+} // namespace
+
+// Only the rows of the page shown get built, the leaderboard can hold any
+// number of games
+ft::Component Leaderboard::component() {
+  const auto total = scores_.size();
+  const auto week = ScoreTable::week(ScoreTable::now());
+  auto pages = std::make_shared<Pages>();
+
+  const auto show = [this, pages, week] {
+    std::vector<ScoreTable::Entry> entries;
+    entries.reserve(shownEntries);
+    const auto view = static_cast<View>(pages->view);
+    if (view == View::History) {
+      const auto &history = scores_.history(); // newest first
+      for (size_t i = pages->page * shownEntries;
+           i < history.size() && entries.size() < shownEntries; i++)
+        entries.push_back(history[history.size() - 1 - i]);
+      pages->total = history.size();
+      pages->last = (pages->page + 1) * shownEntries >= history.size();
+    } else {
+      const auto &ranked =
+          view == View::Best ? scores_.ranked()
+          : view == View::EasyWeek ? scores_.ranked(Difficulty::Easy, week)
+                                   : scores_.ranked(Difficulty::Hard, week);
+      if (pages->starts.empty())
+        pages->starts.push_back(ranked.begin());
+      auto it = pages->starts[pages->page];
+      for (; it != ranked.end() && entries.size() < shownEntries; ++it)
+        entries.push_back(*it);
+      pages->total = ranked.size();
+      pages->last = it == ranked.end();
+      if (!pages->last && pages->starts.size() == pages->page + 1)
+        pages->starts.push_back(it);
+    }
+    pages->table = table(entries, pages->page * shownEntries);
+  };
+  show();
+
+  ft::MenuEntryOption entryOption = {
+      .transform = [](const ft::EntryState &state) {
+        auto element = ft::text(state.label) | ft::border;
+        if (state.active)
+          element |= ft::bold;
+        if (state.focused)
+          element |= ft::inverted;
+        return element;
+      }};
+  auto views = ft::Menu({.entries = &viewNames,
+                         .selected = &pages->view,
+                         .entries_option = entryOption,
+                         .direction = ft::Direction::Right,
+                         .on_change =
+                             [pages, show] {
+                               pages->page = 0;
+                               pages->starts.clear();
+                               show();
+                             }});
+  ft::ButtonOption buttonOption = {.transform = entryOption.transform};
+  auto previous = ft::Button(
+      "Previous",
+      [pages, show] {
+        if (pages->page == 0)
+          return;
+        pages->page--;
+        show();
+      },
+      buttonOption);
+  auto next = ft::Button(
+      "Next",
+      [pages, show] {
+        if (pages->last)
+          return;
+        pages->page++;
+        show();
+      },
+      buttonOption);
+  auto pageButtons = ft::Container::Horizontal({previous, next});
+
+  auto leaderboardView = ft::Renderer(
+      ft::Container::Vertical({views, pageButtons}), [=] {
+        const auto pageCount =
+            std::max<size_t>(1, (pages->total + shownEntries - 1) /
+                                    shownEntries);
+        return ft::vbox(
+            views->Render() | ft::hcenter, pages->table | ft::hcenter,
+            ft::hbox(previous->Render(),
+                     ft::text(std::format(" Page {} of {}, {} games ",
+                                          pages->page + 1, pageCount,
+                                          pages->total)) |
+                         ft::vcenter,
+                     next->Render()) |
+                ft::hcenter);
+      });
 
-  auto upperLeaderBoardscreen = ft::Renderer([=, *this] {
+  auto upperLeaderBoardscreen = ft::Renderer(leaderboardView, [=] {
     auto header =
         ft::vbox(utils::textSplit(leaderboardHeader_), ft::separator()) |
         ft::color(utils::headerGradient);
-    if (leaderboard_.empty())
+    if (total == 0)
       return ft::vbox(
           header,
           ft::text("The leaderboard is empty play a game to fill it up!") |
               ft::hcenter);
 
-    return ft::vbox(header, leaderboardElement | ft::hcenter);
+    return ft::vbox(header, leaderboardView->Render());
   });
 
   auto bottomLeaderboardScreen =
@@ -1,4 +1,5 @@
 #include "solitairecpp/error.hpp"
+#include <algorithm>
 #include <expected>
 #include <ftxui/component/component.hpp>
 #include <ftxui/component/event.hpp>
@@ -13,198 +14,236 @@
 
 namespace solitairecpp {
 
-MoveManager::MoveManager(const Board &elements) : board_{elements} {}
+MoveManager::MoveManager(Board &elements) : board_{elements} {}
 
 bool MoveManager::isTargetError(const CardPosition &pos) const {
-  if (!erroneusTarget_.load().has_value())
+  if (!std::holds_alternative<Tableau::CardPosition>(pos))
     return false;
-  if (std::holds_alternative<Tableau::CardPosition>(pos) &&
-      std::holds_alternative<Tableau::CardPosition>(
-          erroneusTarget_.load().value())) {
-    return std::get<Tableau::CardPosition>(pos) ==
-           std::get<Tableau::CardPosition>(erroneusTarget_.load().value());
-  }
-
-  return false;
+  return slot(transaction_.load(std::memory_order_acquire),
+              erroneusTargetShift_) == pack(pos);
 }
 
-bool MoveManager::moveTransactionOpen() const {
-  return moveFrom_.load() != std::nullopt;
-}
-
-// this one couldn't be any smaller
-std::expected<void, Error> MoveManager::Move() {
-  if (!moveFrom_.load().has_value() || !moveTo_.load().has_value()) {
-    endTransaction();
-    return std::unexpected(ErrorIllegalMove().error());
-  }
-
-  const auto from = moveFrom_.load().value();
-  const auto to = moveTo_.load().value();
+bool MoveManager::isHint(const CardPosition &pos) const {
+  const auto move = currentHint();
+  if (!move || move->isDraw())
+    return false;
 
-  if (std::holds_alternative<Tableau::CardPosition>(from) &&
-      std::holds_alternative<Tableau::CardPosition>(to)) {
-    auto success = moveHelper(std::get<Tableau::CardPosition>(from),
-                              std::get<Tableau::CardPosition>(to));
-    if (!success) {
-      endTransaction();
-      return std::unexpected(success.error());
-    }
-  } else if (std::holds_alternative<Tableau::CardPosition>(from) &&
-             std::holds_alternative<Foundations::CardPosition>(to)) {
-    auto success = moveHelper(std::get<Tableau::CardPosition>(from),
-                              std::get<Foundations::CardPosition>(to));
-    if (!success) {
-      endTransaction();
-      return std::unexpected(success.error());
-    }
-  } else if (std::holds_alternative<ReserveStack::CardPosition>(from) &&
-             std::holds_alternative<Tableau::CardPosition>(to)) {
-    auto success = moveHelper(std::get<ReserveStack::CardPosition>(from),
-                              std::get<Tableau::CardPosition>(to));
-    if (!success) {
-      endTransaction();
-      return std::unexpected(success.error());
-    }
-  } else if (std::holds_alternative<ReserveStack::CardPosition>(from) &&
-             std::holds_alternative<Foundations::CardPosition>(to)) {
-    auto success = moveHelper(std::get<ReserveStack::CardPosition>(from),
-                              std::get<Foundations::CardPosition>(to));
-    if (!success) {
-      endTransaction();
-      return std::unexpected(success.error());
-    }
-  } else if (std::holds_alternative<ReserveStack::CardPosition>(from) &&
-             std::holds_alternative<ReserveStack::CardPosition>(to)) {
-    /* do nothing because reserve stack will deal with this */
-  } else {
-    endTransaction();
-    return std::unexpected(ErrorIllegalMove().error());
+  if (std::holds_alternative<Tableau::CardPosition>(pos)) {
+    const auto tableau = std::get<Tableau::CardPosition>(pos);
+    if (tableau.cardRowIndex >= Piles::tableauSize)
+      return false;
+    const auto pile = Piles::tableau(tableau.cardRowIndex);
+    const auto size = board_.state().tableauRow(tableau.cardRowIndex).size();
+    if (move->from == pile)
+      return tableau.cardIndex >= size - move->count &&
+             tableau.cardIndex < size;
+    return move->to == pile && tableau.cardIndex == size; // the target bar
   }
-
-  if (history_.size() == maxHistorySize_)
-    history_.erase(history_.begin());
-  history_.emplace_back(from, to);
-  moveCount_++;
-  endTransaction();
-  return std::expected<void, Error>();
+  if (std::holds_alternative<ReserveStack::CardPosition>(pos))
+    return move->from == Piles::waste;
+  return move->to ==
+         Piles::foundation(std::get<Foundations::CardPosition>(pos)
+                               .foundationIndex);
 }
 
-std::expected<void, Error>
-MoveManager::moveHelper(const Tableau::CardPosition &from,
-                        const Tableau::CardPosition &to) {
-  auto cards = board_.tableau().getCardsFrom(from);
-  if (!cards)
-    throw std::runtime_error(cards.error()->what());
+// called for every card on every frame, the cards were picked by hint()
+bool MoveManager::isHint(const CardCode &code) const {
+  if (slot(transaction_.load(std::memory_order_acquire), hintShift_) == 0)
+    return false;
+  return hintCards_.load(std::memory_order_relaxed) >>
+             PackedCard(code).index() &
+         1;
+}
 
-  auto legalSuccess =
-      board_.tableau().isAppendToLegal({to.cardRowIndex}, cards.value());
-  if (!legalSuccess)
-    throw std::runtime_error(legalSuccess.error()->what());
+bool MoveManager::isDrawHint() const {
+  const auto move = currentHint();
+  return move && move->isDraw();
+}
 
-  if (!legalSuccess.value())
-    return std::unexpected(ErrorIllegalMove().error());
+std::optional<MoveManager::EngineMove> MoveManager::currentHint() const {
+  return unpackHint(
+      slot(transaction_.load(std::memory_order_acquire), hintShift_));
+}
 
-  auto deleteSuccess = board_.tableau().deleteFrom(from);
-  if (!deleteSuccess)
-    throw std::runtime_error(deleteSuccess.error()->what());
+bool MoveManager::moveTransactionOpen() const {
+  return slot(transaction_.load(std::memory_order_acquire), moveFromShift_) !=
+         0;
+}
 
-  auto appendSuccess =
-      board_.tableau().appendTo({to.cardRowIndex}, cards.value());
-  if (!appendSuccess)
-    throw std::runtime_error(appendSuccess.error()->what());
+MoveManager::PackedPosition MoveManager::pack(const CardPosition &pos) {
+  PackedPosition packed = positionPresent_ | (pos.index() << 12);
+  if (std::holds_alternative<Tableau::CardPosition>(pos)) {
+    const auto tableau = std::get<Tableau::CardPosition>(pos);
+    packed |= (tableau.cardRowIndex & 0xf) << 8;
+    packed |= tableau.cardIndex & 0xff;
+  } else if (std::holds_alternative<Foundations::CardPosition>(pos)) {
+    packed |= (std::get<Foundations::CardPosition>(pos).foundationIndex & 0xf)
+              << 8;
+  }
+  return packed;
+}
 
-  return std::expected<void, Error>();
+std::optional<CardPosition> MoveManager::unpack(PackedPosition packed) {
+  if (!(packed & positionPresent_))
+    return std::nullopt;
+
+  const size_t row = (packed >> 8) & 0xf;
+  switch ((packed >> 12) & 0x3) {
+  case 0:
+    return Tableau::CardPosition{.cardRowIndex = row,
+                                 .cardIndex = packed & 0xffu};
+  case 1:
+    return ReserveStack::CardPosition{};
+  default:
+    return Foundations::CardPosition{.foundationIndex = row};
+  }
 }
 
-// fix this one
-std::expected<void, Error>
-MoveManager::moveHelper(const Tableau::CardPosition &from,
-                        const Foundations::CardPosition &to) {
-  auto card = board_.tableau().getCardsFrom(from);
-  if (!card)
-    throw std::runtime_error(card.error()->what());
+MoveManager::PackedPosition MoveManager::packHint(const EngineMove &move) {
+  static_assert(Piles::count <= 0x10 && GameState::maxTableauRowSize < 0x20);
+  return positionPresent_ | (move.from << 9) | (move.to << 5) | move.count;
+}
 
-  if (card.value().size() > 1) // cards get set one by one to foundations
-    return std::unexpected(ErrorIllegalMove().error());
+std::optional<MoveManager::EngineMove>
+MoveManager::unpackHint(PackedPosition packed) {
+  if (!(packed & positionPresent_))
+    return std::nullopt;
+  return EngineMove{.from = static_cast<PileId>((packed >> 9) & 0xf),
+                    .to = static_cast<PileId>((packed >> 5) & 0xf),
+                    .count = static_cast<std::uint8_t>(packed & 0x1f)};
+}
 
-  auto legalSuccess = board_.foundations().isSetLegal(to, card.value().at(0));
-  if (!legalSuccess)
-    throw std::runtime_error(legalSuccess.error()->what());
-  if (!legalSuccess.value())
-    return std::unexpected(ErrorIllegalMove().error());
+void MoveManager::hint() {
+  const auto move = board_.hint();
+  if (move)
+    hintCards_.store(hintCards(move.value()), std::memory_order_relaxed);
+  store(hintShift_, move ? packHint(move.value()) : 0);
+}
 
-  auto deleteSuccess = board_.tableau().deleteFrom(from);
-  if (!deleteSuccess)
-    throw std::runtime_error(deleteSuccess.error()->what());
+// Same as searching every card and asking isHint about it's position: the
+// moving cards, every card of the waste and of a target foundation
+std::uint64_t MoveManager::hintCards(const EngineMove &move) const {
+  const auto &state = board_.state();
+  std::uint64_t cards{};
+  const auto mark = [&](PileId pile, size_t count) {
+    const auto size = state.pileSize(pile);
+    for (size_t depth{size - std::min(count, size)}; depth < size; depth++)
+      cards |= std::uint64_t{1} << state.pileCard(pile, depth).index();
+  };
+  if (move.isDraw())
+    return cards;
+  if (Piles::isTableau(move.from))
+    mark(move.from, move.count);
+  else if (move.from == Piles::waste)
+    mark(Piles::waste, state.pileSize(Piles::waste));
+  if (Piles::isFoundation(move.to))
+    mark(move.to, state.pileSize(move.to));
+  return cards;
+}
 
-  auto appendSuccess = board_.foundations().setCard(to, card.value().at(0));
-  if (!appendSuccess)
-    throw std::runtime_error(appendSuccess.error()->what());
+MoveManager::PackedPosition MoveManager::slot(TransactionWord word,
+                                              unsigned shift) {
+  return static_cast<PackedPosition>(word >> shift);
+}
 
-  return std::expected<void, Error>();
+MoveManager::TransactionWord MoveManager::withSlot(TransactionWord word,
+                                                   unsigned shift,
+                                                   PackedPosition packed) {
+  word &= ~(TransactionWord{0xffff} << shift);
+  return word | (TransactionWord{packed} << shift);
 }
 
-std::expected<void, Error>
-MoveManager::moveHelper(const ReserveStack::CardPosition &from,
-                        const Tableau::CardPosition &to) {
-  auto card = board_.reserveStack().getTopCard();
-  if (!card)
-    throw std::runtime_error(card.error()->what());
+void MoveManager::store(unsigned shift, PackedPosition packed) {
+  auto word = transaction_.load(std::memory_order_relaxed);
+  while (!transaction_.compare_exchange_weak(
+      word, withSlot(word, shift, packed), std::memory_order_acq_rel)) {
+  }
+}
 
-  auto legalSuccess =
-      board_.tableau().isAppendToLegal({to.cardRowIndex}, {card.value()});
-  if (!legalSuccess)
-    throw std::runtime_error(legalSuccess.error()->what());
-  if (!legalSuccess.value())
-    return std::unexpected(ErrorIllegalMove().error());
+std::expected<void, ErrorCode> MoveManager::Move() {
+  const auto word = transaction_.load(std::memory_order_acquire);
+  const auto from = unpack(slot(word, moveFromShift_));
+  const auto to = unpack(slot(word, moveToShift_));
+  if (!from.has_value() || !to.has_value()) {
+    endTransaction();
+    return std::unexpected(ErrorCode::IllegalMove);
+  }
 
-  auto deleteSuccess = board_.reserveStack().deleteTopCard();
-  if (!deleteSuccess)
-    throw std::runtime_error(deleteSuccess.error()->what());
+  auto move = toEngineMove(from.value(), to.value());
+  if (!move) {
+    endTransaction();
+    return std::unexpected(move.error());
+  }
 
-  auto appendSuccess =
-      board_.tableau().appendTo({to.cardRowIndex}, {card.value()});
-  if (!appendSuccess)
-    throw std::runtime_error(appendSuccess.error()->what());
+  auto success = board_.apply(move.value());
+  if (!success) {
+    endTransaction();
+    return std::unexpected(success.error());
+  }
 
-  return std::expected<void, Error>();
+  store(hintShift_, 0); // it was for the position before
+  endTransaction();
+  return std::expected<void, ErrorCode>();
 }
 
-std::expected<void, Error>
-MoveManager::moveHelper(const ReserveStack::CardPosition &from,
-                        const Foundations::CardPosition &to) {
-  auto card = board_.reserveStack().getTopCard();
-  if (!card)
-    throw std::runtime_error(card.error()->what());
-
-  auto legalSuccess = board_.foundations().isSetLegal(to, {card.value()});
-  if (!legalSuccess)
-    throw std::runtime_error(legalSuccess.error()->what());
-
-  if (!legalSuccess.value())
-    return std::unexpected(ErrorIllegalMove().error());
-
-  auto deleteSuccess = board_.reserveStack().deleteTopCard();
-  if (!deleteSuccess)
-    throw std::runtime_error(deleteSuccess.error()->what());
+std::expected<MoveManager::EngineMove, ErrorCode>
+MoveManager::toEngineMove(const CardPosition &from,
+                          const CardPosition &to) const {
+  // revealing from the reserve stack
+  if (std::holds_alternative<ReserveStack::CardPosition>(from) &&
+      std::holds_alternative<ReserveStack::CardPosition>(to))
+    return EngineMove::draw();
+
+  EngineMove move{};
+  if (std::holds_alternative<Tableau::CardPosition>(from)) {
+    const auto pos = std::get<Tableau::CardPosition>(from);
+    if (pos.cardRowIndex >= Piles::tableauSize)
+      return std::unexpected(ErrorCode::InvalidCardIndex);
+
+    const auto size = board_.state().tableauRow(pos.cardRowIndex).size();
+    if (pos.cardIndex >= size)
+      return std::unexpected(ErrorCode::InvalidCardIndex);
+
+    move.from = Piles::tableau(pos.cardRowIndex);
+    move.count = static_cast<std::uint8_t>(size - pos.cardIndex);
+  } else if (std::holds_alternative<ReserveStack::CardPosition>(from)) {
+    move.from = Piles::waste;
+    move.count = 1;
+  } else {
+    return std::unexpected(ErrorCode::IllegalMove);
+  }
 
-  auto appendSuccess = board_.foundations().setCard(to, {card.value()});
-  if (!appendSuccess) {
-    throw std::runtime_error(appendSuccess.error()->what());
+  if (std::holds_alternative<Tableau::CardPosition>(to)) {
+    const auto pos = std::get<Tableau::CardPosition>(to);
+    if (pos.cardRowIndex >= Piles::tableauSize)
+      return std::unexpected(ErrorCode::InvalidCardIndex);
+    move.to = Piles::tableau(pos.cardRowIndex);
+  } else if (std::holds_alternative<Foundations::CardPosition>(to)) {
+    const auto pos = std::get<Foundations::CardPosition>(to);
+    if (pos.foundationIndex >= Piles::foundationsSize)
+      return std::unexpected(ErrorCode::InvalidCardIndex);
+    move.to = Piles::foundation(pos.foundationIndex);
+  } else {
+    return std::unexpected(ErrorCode::IllegalMove);
   }
-  return std::expected<void, Error>();
+
+  return move;
 }
 
 void MoveManager::setMoveTarget(const CardPosition &pos) {
-  if (moveTo_.load() != std::nullopt)
-    erroneusTarget_ = pos;
+  const auto packed = pack(pos);
+  auto word = transaction_.load(std::memory_order_relaxed);
+  TransactionWord next;
+  do {
+    next = withSlot(word, moveToShift_, packed);
+    if (slot(word, moveToShift_) != 0)
+      next = withSlot(next, erroneusTargetShift_, packed);
+  } while (!transaction_.compare_exchange_weak(word, next,
+                                               std::memory_order_acq_rel));
 
-  // add logic
-  moveTo_ = pos;
   auto success = Move();
   if (!success)
-    erroneusTarget_ = pos;
+    store(erroneusTargetShift_, packed);
 };
 
 void MoveManager::setMoveTarget(const CardCode &code) {
@@ -216,17 +255,20 @@ void MoveManager::setMoveTarget(const CardCode &code) {
 }
 
 void MoveManager::setMoveOrigin(const CardPosition &pos) {
-  // another move started so we reset the erroneusTarget_
-  if (erroneusTarget_.load().has_value())
-    erroneusTarget_ = std::nullopt;
-
-  // Find the thing
-  if (moveFrom_.load() == std::nullopt)
-    moveFrom_ = pos;
+  const auto packed = pack(pos);
+  auto word = transaction_.load(std::memory_order_relaxed);
+  TransactionWord next;
+  do {
+    // another move started so we reset the erroneusTarget_
+    next = withSlot(word, erroneusTargetShift_, 0);
+    if (slot(word, moveFromShift_) == 0)
+      next = withSlot(next, moveFromShift_, packed);
+  } while (!transaction_.compare_exchange_weak(word, next,
+                                               std::memory_order_acq_rel));
 }
 
 void MoveManager::cardSelected(const CardCode &code) {
-  if (moveFrom_.load() == std::nullopt) {
+  if (!moveTransactionOpen()) {
     auto position = board_.search(code);
     if (!position)
       throw std::runtime_error(position.error()->what());
@@ -234,12 +276,20 @@ void MoveManager::cardSelected(const CardCode &code) {
   }
 }
 
+// the engine treats revealing as a move from the stock to the waste
+void MoveManager::draw() {
+  endTransaction();
+  setMoveOrigin(ReserveStack::CardPosition{});
+  setMoveTarget(ReserveStack::CardPosition{});
+}
+
 void MoveManager::endTransaction() {
-  moveFrom_ = std::nullopt;
-  moveTo_ = std::nullopt;
+  const auto cleared = (TransactionWord{0xffff} << moveFromShift_) |
+                       (TransactionWord{0xffff} << moveToShift_);
+  transaction_.fetch_and(~cleared, std::memory_order_acq_rel);
 }
 
-size_t MoveManager::moveCount() const { return moveCount_; }
+size_t MoveManager::moveCount() const { return board_.moveCount(); }
 
 ft::ComponentDecorator MoveManager::moveTransactionCanceledListener() {
   return ft::CatchEvent([&](ft::Event event) {
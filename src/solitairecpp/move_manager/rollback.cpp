@@ -1,19 +1,30 @@
 #include <ftxui/dom/elements.hpp>
+#include <functional>
+#include <solitairecpp/auto_complete.hpp>
 #include <solitairecpp/board.hpp>
 #include <solitairecpp/move_manager.hpp>
+#include <solitairecpp/utils.hpp>
 #include <stdexcept>
 
 namespace solitairecpp {
 
-ft::Component MoveManager::rollbackButton() {
-  return ft::Button("Revert move(Up to 3 moves)",
-                    [&] {
-                      if (!history_.empty())
-                        rollback();
+namespace {
+
+// the buttons under the reserve stack look the same, they only differ in what
+// they ask the session
+ft::Component historyButton(const std::string &label,
+                            std::function<bool()> enabled,
+                            std::function<void()> action) {
+  return ft::Button(label,
+                    [=] {
+                      utils::post([=] {
+                        if (enabled())
+                          action();
+                      });
                     },
-                    {.transform = [&](const ft::EntryState &state) {
+                    {.transform = [=](const ft::EntryState &state) {
                       auto element = ft::text(state.label) | ft::border;
-                      if (history_.empty())
+                      if (!enabled())
                         return element | ft::color(ft::Color::GrayDark);
 
                       if (state.active)
@@ -25,109 +36,51 @@ ft::Component MoveManager::rollbackButton() {
                     }});
 }
 
-void MoveManager::rollback() {
-  if (history_.empty())
-    return;
-
-  auto transaction = history_.back();
-  history_.erase(history_.end() - 1);
-  // Ok this may look weird, but that's C++
-  if (std::holds_alternative<Tableau::CardPosition>(transaction.to) &&
-      std::holds_alternative<Tableau::CardPosition>(transaction.from)) {
-    rollbackHelper(std::get<Tableau::CardPosition>(transaction.to),
-                   std::get<Tableau::CardPosition>(transaction.from));
-
-  } else if (std::holds_alternative<Foundations::CardPosition>(
-                 transaction.to) &&
-             std::holds_alternative<Tableau::CardPosition>(transaction.from)) {
-    rollbackHelper(std::get<Foundations::CardPosition>(transaction.to),
-                   std::get<Tableau::CardPosition>(transaction.from));
+} // namespace
 
-  } else if (std::holds_alternative<Tableau::CardPosition>(transaction.to) &&
-             std::holds_alternative<ReserveStack::CardPosition>(
-                 transaction.from)) {
-    rollbackHelper(std::get<Tableau::CardPosition>(transaction.to),
-                   std::get<ReserveStack::CardPosition>(transaction.from));
-
-  } else if (std::holds_alternative<Foundations::CardPosition>(
-                 transaction.to) &&
-             std::holds_alternative<ReserveStack::CardPosition>(
-                 transaction.from)) {
-    rollbackHelper(std::get<Foundations::CardPosition>(transaction.to),
-                   std::get<ReserveStack::CardPosition>(transaction.from));
-
-  } else if (std::holds_alternative<ReserveStack::CardPosition>(
-                 transaction.to) &&
-             std::holds_alternative<ReserveStack::CardPosition>(
-                 transaction.from)) {
-    rollbackHelper(std::get<ReserveStack::CardPosition>(transaction.to),
-                   std::get<ReserveStack::CardPosition>(transaction.from));
-  } else {
-    throw std::runtime_error("Illegal rollback operation");
-  }
-
-  moveCount_--;
+ft::Component MoveManager::rollbackButton() {
+  return historyButton(
+      "Undo move", [this] { return board_.session().canUndo(); },
+      [this] { rollback(); });
 }
 
-void MoveManager::rollbackHelper(const Tableau::CardPosition &from,
-                                 const Tableau::CardPosition &to) {
-  auto cards = board_.tableau().getCardsFrom(from);
-  if (!cards)
-    throw std::runtime_error(cards.error()->what());
-
-  auto deleteSuccess = board_.tableau().deleteFrom(from);
-  if (!deleteSuccess)
-    throw std::runtime_error(deleteSuccess.error()->what());
-
-  auto appendSuccess =
-      board_.tableau().appendToRollback({to.cardRowIndex}, cards.value());
-  if (!appendSuccess)
-    throw std::runtime_error(appendSuccess.error()->what());
+ft::Component MoveManager::redoButton() {
+  return historyButton(
+      "Redo move", [this] { return board_.session().canRedo(); },
+      [this] { redo(); });
 }
 
-void MoveManager::rollbackHelper(const Foundations::CardPosition &from,
-                                 const Tableau::CardPosition &to) {
-  auto card = board_.foundations().acquireCard(from);
-  if (!card)
-    throw std::runtime_error(card.error()->what());
-
-  auto appendSuccess =
-      board_.tableau().appendToRollback({to.cardRowIndex}, {card.value()});
-  if (!appendSuccess)
-    throw std::runtime_error(appendSuccess.error()->what());
+ft::Component MoveManager::hintButton() {
+  return historyButton(
+      "Hint", [this] { return !board_.state().won(); }, [this] { hint(); });
 }
 
-void MoveManager::rollbackHelper(const Tableau::CardPosition &from,
-                                 const ReserveStack::CardPosition &to) {
-  auto card = board_.tableau().getCardsFrom(from);
-  if (!card)
-    throw std::runtime_error(card.error()->what());
-
-  auto deleteSuccess = board_.tableau().deleteFrom(from);
-  if (!deleteSuccess)
-    throw std::runtime_error(card.error()->what());
-
-  auto setSuccess = board_.reserveStack().setTopCard(card.value().at(0));
-  if (!setSuccess)
-    throw std::runtime_error(setSuccess.error()->what());
+ft::Component MoveManager::autoCompleteButton() {
+  return historyButton(
+      "Auto complete",
+      [this] { return AutoComplete::next(board_.state()).has_value(); },
+      [this] { autoComplete(); });
 }
 
-void MoveManager::rollbackHelper(const Foundations::CardPosition &from,
-                                 const ReserveStack::CardPosition &to) {
-  auto card = board_.foundations().acquireCard(from);
-  if (!card)
-    throw std::runtime_error(card.error()->what());
+void MoveManager::rollback() {
+  auto success = board_.undo();
+  if (!success)
+    throw std::runtime_error(toError(success.error())->what());
+  store(hintShift_, 0);
+}
 
-  auto setSuccess = board_.reserveStack().setTopCard(card.value());
-  if (!setSuccess)
-    throw std::runtime_error(setSuccess.error()->what());
+// the whole batch is one posted task, so the screen redraws once at the end
+void MoveManager::autoComplete() {
+  endTransaction();
+  board_.autoComplete();
+  store(hintShift_, 0);
 }
 
-void MoveManager::rollbackHelper(const ReserveStack::CardPosition &from,
-                                 const ReserveStack::CardPosition &to) {
-  auto rollbackSuccess = board_.reserveStack().rollbackCard();
-  if (!rollbackSuccess)
-    throw std::runtime_error(rollbackSuccess.error()->what());
+void MoveManager::redo() {
+  auto success = board_.redo();
+  if (!success)
+    throw std::runtime_error(toError(success.error())->what());
+  store(hintShift_, 0);
 }
 
 }; // namespace solitairecpp
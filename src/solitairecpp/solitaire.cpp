@@ -1,18 +1,52 @@
+#include <chrono>
+#include <condition_variable>
+#include <format>
 #include <ftxui/component/component.hpp>
 #include <ftxui/component/component_options.hpp>
 #include <ftxui/component/screen_interactive.hpp>
 #include <ftxui/dom/direction.hpp>
 #include <ftxui/dom/elements.hpp>
+#include <mutex>
+#include <solitairecpp/journal.hpp>
+#include <solitairecpp/paths.hpp>
+#include <solitairecpp/snapshot.hpp>
 #include <solitairecpp/solitairecpp.hpp>
 #include <solitairecpp/utils.hpp>
+#include <string>
+#include <thread>
+#include <utility>
 
 namespace solitairecpp {
 
+Game::Game(const Cli::Options &options)
+    : requestedDealNumber_{options.dealNumber}, analysis_{options.analysis} {}
+
 void Game::Start() {
-  auto success = chooseModeScreen();
-  if (!success)
-    return;
-  mainLoop();
+  auto resumed = loadSnapshot();
+  if (!resumed) {
+    auto success = chooseModeScreen();
+    if (!success)
+      return;
+  }
+  openDealDatabase();
+  mainLoop(std::move(resumed));
+}
+
+// A game that was left unfinished is picked up where it was, on the first
+// start only, later ones are restarts. A deal asked for on the command line
+// gets played instead.
+std::optional<Snapshot::Loaded> Game::loadSnapshot() {
+  const bool firstStart = std::exchange(firstStart_, false);
+  if (!firstStart || requestedDealNumber_)
+    return std::nullopt;
+
+  // the board saves it again as soon as it's up
+  auto loaded = Snapshot::load(Paths::snapshot().string());
+  if (!loaded)
+    return std::nullopt;
+
+  mode_ = loaded->session.state().mode();
+  return std::move(loaded.value());
 }
 
 // function is large because of components. In ui component functions it will be
@@ -83,11 +117,41 @@ std::expected<void, Error> Game::chooseModeScreen() {
   return std::expected<void, Error>();
 }
 
-void Game::mainLoop() {
+void Game::mainLoop(std::optional<Snapshot::Loaded> resumed) {
   auto screen = ft::ScreenInteractive::Fullscreen();
   bool won = false;
+  const bool resuming = resumed.has_value();
+  Session session = resuming ? std::move(resumed->session)
+                             : Session(mode_, nextDealNumber());
+  const auto progress = resuming ? resumed->progress : Snapshot::Progress{};
+  const auto dealNumber = session.state().dealNumber();
+  par_.request(mode_, dealNumber); // ready long before the game is won
+  // the game goes on without a journal when it can't be written
+  const auto journalPath = Paths::journal().string();
+  auto journal =
+      resuming ? JournalWriter::append(journalPath, mode_, dealNumber,
+                                       progress.journalRecords)
+               : JournalWriter::create(journalPath, mode_, dealNumber);
+  if (resuming && !journal)
+    journal = JournalWriter::rebuild(journalPath, session);
+  // a resumed game's clock goes on from the time it was saved with
+  const auto started = std::chrono::steady_clock::now() - progress.playTime;
+  const auto playTime = [&] {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - started);
+  };
+  const Board *playing{}; // set once the board is made, before any move
   Board::GameCallbacks callbacks = {
-      .onGameWon = [&] { won = true; },
+      .onGameWon =
+          [&] {
+            if (std::exchange(won, true))
+              return;
+            // registered right away, the win screen can be left any way
+            leaderboard_.registerScore(playing->moveCount(), mode_,
+                                       playing->state().dealNumber(),
+                                       playTime());
+            autosave_.discard(); // nothing left to resume
+          },
       .restartGame =
           [&] {
             screen.Exit();
@@ -100,8 +164,21 @@ void Game::mainLoop() {
             screen.Loop(ft::Renderer(leaderboardComponent, [=] {
               return leaderboardComponent->Render() | ft::center;
             }));
+          },
+      // the board records a move in the journal before it calls this
+      .onChanged =
+          [&](const Session &session) {
+            const auto records = journal ? journal->size() : 0;
+            autosave_.save(
+                session,
+                {.journalRecords = static_cast<std::uint32_t>(records),
+                 .playTime = playTime()});
           }};
-  Board board(mode_, callbacks);
+  // looked up before this game is in the leaderboard
+  const auto best = leaderboard_.best(mode_, dealNumber);
+  Board board(std::move(session), callbacks, analysis_,
+              journal ? &journal.value() : nullptr);
+  playing = &board;
   ft::ButtonOption winScreenButtonOpt = {
       .transform = [](const ft::EntryState &state) {
         auto element =
@@ -113,16 +190,22 @@ void Game::mainLoop() {
         return element;
       }};
   auto winScreen = ft::Container::Vertical(
-      {ft::Renderer([] {
-         return ft::vbox(utils::textSplit(winSplash_)) |
-                ft::color(utils::headerGradient);
+      {ft::Renderer([&] {
+         std::string record = "First win of this deal";
+         if (best && board.moveCount() < best.value())
+           record = std::format("New best for this deal, it was {} moves",
+                                best.value());
+         else if (best)
+           record = std::format("The best for this deal is {} moves",
+                                best.value());
+         return ft::vbox(ft::vbox(utils::textSplit(winSplash_)) |
+                             ft::color(utils::headerGradient),
+                         ft::text(record) | ft::hcenter);
        }),
        ft::Container::Horizontal({ft::Button(
                                       "Play again",
                                       [&] {
                                         screen.Exit();
-                                        leaderboard_.registerScore(
-                                            board.moveCount());
                                         Start();
                                       },
                                       winScreenButtonOpt),
@@ -144,4 +227,86 @@ void Game::mainLoop() {
   screen.Loop(boardComponent | utils::exitListener());
 }
 
+void Game::Replay(const Journal &journal, double movesPerSecond) {
+  auto screen = ft::ScreenInteractive::Fullscreen();
+  Board board(Session(journal.mode(), journal.dealNumber()),
+              {.onGameWon = [] {},
+               .restartGame = screen.ExitLoopClosure(),
+               .viewLeadearBoard = [] {}});
+
+  // Stopped and joined before the board goes, tasks still queued then never
+  // run. The wait between records ends as soon as the stop comes, however
+  // slow the replay.
+  const auto interval = std::chrono::duration<double>(1 / movesPerSecond);
+  std::mutex mutex;
+  std::condition_variable_any wake; // nothing notifies it but the stop
+  std::jthread player([&](std::stop_token stop) {
+    std::unique_lock lock(mutex);
+    for (size_t i{}; i < journal.size(); i++) {
+      if (wake.wait_for(lock, stop, interval,
+                        [&] { return stop.stop_requested(); }))
+        break;
+      const auto record = journal.at(i);
+      if (!record)
+        break;
+      screen.Post([&board, record = record.value()] {
+        switch (record.kind) {
+        case Journal::Kind::Apply: {
+          auto move = record.move;
+          board.apply(move);
+          break;
+        }
+        case Journal::Kind::Undo:
+          board.undo();
+          break;
+        case Journal::Kind::Redo:
+          board.redo();
+          break;
+        }
+      });
+      screen.PostEvent(ft::Event::Custom);
+    }
+  });
+  screen.Loop(board.component() | utils::exitListener());
+}
+
+// Opening is just a mmap, the deals are read when one gets drawn. Without a
+// database new deals get solved at startup instead.
+void Game::openDealDatabase() {
+  if (deals_ && deals_->mode() == mode_)
+    return;
+
+  deals_.reset();
+  auto deals = DealDatabase::open(Paths::dealDatabase(mode_).string());
+  if (deals && deals->mode() == mode_ && deals->size() != 0)
+    deals_ = std::move(deals.value());
+}
+
+// The deal from the command line is only used for the first game
+std::uint64_t Game::nextDealNumber() {
+  if (!requestedDealNumber_) {
+    if (deals_)
+      return deals_->draw(Session::randomDealNumber());
+    return winnableDealNumber();
+  }
+
+  auto dealNumber = requestedDealNumber_.value();
+  requestedDealNumber_.reset();
+  return dealNumber;
+}
+
+// Only hands out deals the solver could win. One it couldn't decide in time
+// gets skipped too, if none works out one of the proven deals is played.
+std::uint64_t Game::winnableDealNumber() const {
+  Solver solver(dealSolverLimits_);
+  for (size_t i{}; i < maxDealAttempts_; i++) {
+    const auto dealNumber = Session::randomDealNumber();
+    const auto result = solver.solve(GameState(mode_, dealNumber));
+    if (result.status == Solver::Status::Solved)
+      return dealNumber;
+  }
+  const auto &proven = provenDeals_[static_cast<size_t>(mode_)];
+  return proven[Session::randomDealNumber() % proven.size()];
+}
+
 } // namespace solitairecpp
@@ -25,4 +25,15 @@ ft::ComponentDecorator utils::exitListener() {
   });
 }
 
+void utils::post(std::function<void()> task) {
+  auto *screen = ft::ScreenInteractive::Active();
+  if (screen == nullptr) {
+    // no loop running (headless use), nothing to redraw either
+    task();
+    return;
+  }
+  screen->Post(std::move(task));
+  screen->PostEvent(ft::Event::Custom);
+}
+
 }; // namespace solitairecpp
@@ -0,0 +1,30 @@
+#pragma once
+
+// Argument parsing shared by the headless tools, they take positional
+// arguments only.
+#include <charconv>
+#include <cstdint>
+#include <optional>
+#include <solitairecpp/engine.hpp>
+#include <string_view>
+
+namespace solitairecpp::tools {
+
+inline std::optional<std::uint64_t> parseNumber(std::string_view arg) {
+  std::uint64_t number{};
+  auto [end, error] =
+      std::from_chars(arg.data(), arg.data() + arg.size(), number);
+  if (error != std::errc() || end != arg.data() + arg.size())
+    return std::nullopt;
+  return number;
+}
+
+inline std::optional<Difficulty> parseMode(std::string_view arg) {
+  if (arg == "easy")
+    return Difficulty::Easy;
+  if (arg == "hard")
+    return Difficulty::Hard;
+  return std::nullopt;
+}
+
+} // namespace solitairecpp::tools
@@ -0,0 +1,57 @@
+// Usage: solitairecpp_par <deal> [easy|hard] [max nodes]
+//
+// Works out the par of a deal the way the leaderboard does, next to the
+// solution the depth first solver finds, and prints how close to the shortest
+// solution the par is proven to be.
+#include "arguments.hpp"
+#include <cstdint>
+#include <print>
+#include <solitairecpp/core.hpp>
+#include <solitairecpp/par_solver.hpp>
+#include <solitairecpp/solver.hpp>
+
+using namespace solitairecpp;
+using namespace solitairecpp::tools;
+
+int main(int argc, char **argv) {
+  constexpr auto usage =
+      "Usage: solitairecpp_par <deal> [easy|hard] [max nodes]";
+  const auto deal = argc > 1 ? parseNumber(argv[1]) : std::nullopt;
+  const auto mode = argc > 2 ? parseMode(argv[2]) : Difficulty::Easy;
+  ParSolver::Limits limits{.maxTime = std::chrono::minutes(10)};
+  const auto maxNodes = argc > 3 ? parseNumber(argv[3]) : limits.maxNodes;
+  if (argc < 2 || argc > 4 || !deal || !mode || !maxNodes) {
+    std::println(stderr, "{}", usage);
+    return 1;
+  }
+  limits.maxNodes = maxNodes.value();
+
+  const GameState state(mode.value(), deal.value());
+  const auto first = Solver().solve(state);
+  const auto par = ParSolver(limits).solve(state);
+  std::println("lower bound {}", ParSolver::lowerBound(state));
+  if (first.status == Solver::Status::Solved)
+    std::println("first solution {} moves", first.moves.size());
+
+  switch (par.status) {
+  case Solver::Status::Solved:
+    if (par.weight == 0) {
+      std::println("par {} moves, no pass found a shorter solution, {} nodes "
+                   "in {} iterations, {:.3f} s",
+                   par.moves.size(), par.nodes, par.iterations,
+                   par.elapsed.count());
+      break;
+    }
+    std::println("par {} moves, at most {:.3f}x the shortest, {} nodes in "
+                 "{} iterations, {:.3f} s",
+                 par.moves.size(), par.weight, par.nodes, par.iterations,
+                 par.elapsed.count());
+    break;
+  case Solver::Status::Unsolvable:
+    std::println("unsolvable, {} nodes", par.nodes);
+    break;
+  case Solver::Status::Unknown:
+    std::println("no solution within {} nodes", par.nodes);
+    break;
+  }
+}
@@ -0,0 +1,59 @@
+// Usage: solitairecpp_perft <deal> <depth> [easy|hard] [threads]
+//
+// Prints the leaves under every root move, the total and the nodes per
+// second. Run it before and after touching the rules, the totals must match.
+#include "arguments.hpp"
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <print>
+#include <solitairecpp/core.hpp>
+#include <solitairecpp/perft.hpp>
+#include <string_view>
+#include <thread>
+
+using namespace solitairecpp;
+using namespace solitairecpp::tools;
+
+int main(int argc, char **argv) {
+  constexpr auto usage =
+      "Usage: solitairecpp_perft <deal> <depth> [easy|hard] [threads]";
+  if (argc < 3 || argc > 5) {
+    std::println(stderr, "{}", usage);
+    return 1;
+  }
+
+  const auto deal = parseNumber(argv[1]);
+  const auto depth = parseNumber(argv[2]);
+  const std::string_view modeName = argc > 3 ? argv[3] : "easy";
+  const auto mode = parseMode(modeName);
+  const auto threads =
+      argc > 4 ? parseNumber(argv[4])
+               : std::optional<std::uint64_t>(
+                     std::max(1u, std::thread::hardware_concurrency()));
+  if (!deal || !depth || !mode || !threads || threads.value() == 0) {
+    std::println(stderr, "{}", usage);
+    return 1;
+  }
+
+  const GameState state(mode.value(), deal.value());
+  const auto start = std::chrono::steady_clock::now();
+  const auto root = Perft::divide(state, depth.value(), threads.value());
+  const std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+
+  std::uint64_t leaves{};
+  for (const auto &[move, count] : root) {
+    std::println("{:>2} -> {:<2} x{:<2} {}", static_cast<int>(move.from),
+                 static_cast<int>(move.to), static_cast<int>(move.count),
+                 count);
+    leaves += count;
+  }
+  if (depth.value() == 0)
+    leaves = 1;
+
+  std::println("deal {} {} depth {}: {} leaves in {:.3f}s, {:.2f} M leaves/s "
+               "on {} threads",
+               deal.value(), modeName, depth.value(), leaves, elapsed.count(),
+               leaves / elapsed.count() / 1e6, threads.value());
+}
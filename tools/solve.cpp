@@ -0,0 +1,91 @@
+// Usage: solitairecpp_solve <deal> [easy|hard] [threads] [max nodes]
+//
+// Solves the deal on one thread and then on all of them, printing the
+// winning move list and how well the parallel search scaled. Efficiency is
+// the node rate gained per thread; the time speedup can be above or below it
+// since threads search the tree in a different order.
+#include "arguments.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <print>
+#include <solitairecpp/core.hpp>
+#include <solitairecpp/parallel_solver.hpp>
+#include <string_view>
+#include <thread>
+
+using namespace solitairecpp;
+using namespace solitairecpp::tools;
+
+namespace {
+
+std::string_view statusName(Solver::Status status) {
+  switch (status) {
+  case Solver::Status::Solved:
+    return "solved";
+  case Solver::Status::Unsolvable:
+    return "unsolvable";
+  case Solver::Status::Unknown:
+    return "unknown";
+  }
+  return "";
+}
+
+double nodeRate(const Solver::Result &result) {
+  return result.nodes / std::max(result.elapsed.count(), 1e-9);
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  constexpr auto usage =
+      "Usage: solitairecpp_solve <deal> [easy|hard] [threads] [max nodes]";
+  const auto deal = argc > 1 ? parseNumber(argv[1]) : std::nullopt;
+  const auto mode = argc > 2 ? parseMode(argv[2]) : Difficulty::Easy;
+  const auto threads =
+      argc > 3 ? parseNumber(argv[3])
+               : std::optional<std::uint64_t>(
+                     std::max(1u, std::thread::hardware_concurrency()));
+  Solver::Limits limits{.memoryBytes = 256 << 20,
+                        .maxNodes = 50'000'000,
+                        .maxTime = std::chrono::minutes(10)};
+  const auto maxNodes = argc > 4 ? parseNumber(argv[4]) : limits.maxNodes;
+  if (argc < 2 || argc > 5 || !deal || !mode || !threads ||
+      threads.value() == 0 || !maxNodes) {
+    std::println(stderr, "{}", usage);
+    return 1;
+  }
+  limits.maxNodes = maxNodes.value();
+
+  const GameState state(mode.value(), deal.value());
+  const auto single = ParallelSolver(limits, 1).solve(state);
+  const auto parallel = ParallelSolver(limits, threads.value()).solve(state);
+
+  std::println("{:>8} {:>11} {:>6} {:>12} {:>9} {:>10}", "threads", "status",
+               "moves", "nodes", "seconds", "M nodes/s");
+  for (const auto &[count, result] :
+       {std::pair{std::uint64_t{1}, &single},
+        std::pair{threads.value(), &parallel}})
+    std::println("{:>8} {:>11} {:>6} {:>12} {:>9.3f} {:>10.2f}", count,
+                 statusName(result->status), result->moves.size(),
+                 result->nodes, result->elapsed.count(),
+                 nodeRate(*result) / 1e6);
+
+  const auto [fewest, most] = std::minmax_element(
+      parallel.threadNodes.begin(), parallel.threadNodes.end());
+  std::println("speedup {:.2f}x, efficiency {:.0f}%, {} steals, nodes per "
+               "thread {} to {}",
+               single.elapsed.count() /
+                   std::max(parallel.elapsed.count(), 1e-9),
+               100 * nodeRate(parallel) / nodeRate(single) / threads.value(),
+               parallel.steals, *fewest, *most);
+
+  const auto &solution =
+      parallel.status == Solver::Status::Solved ? parallel : single;
+  if (solution.status == Solver::Status::Solved) {
+    std::print("moves:");
+    for (const auto &move : solution.moves)
+      std::print(" {}>{}", static_cast<int>(move.from),
+                 static_cast<int>(move.to));
+    std::println("");
+  }
+}